@@ -0,0 +1,271 @@
+#ifndef NAHS_BRICKS_FEATURE_TEMP_SENSORS_H
+#define NAHS_BRICKS_FEATURE_TEMP_SENSORS_H
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <nahs-Bricks-Lib-HDC1080.h>
+#include <nahs-Bricks-Lib-SHT4x.h>
+#include <nahs-Bricks-Lib-RTCmem.h>
+
+// measurement modes of single-chip sensors (set per sensor with feedback key tim)
+static const uint8_t TEMP_I2C_MODE_DEFAULT = 0;  // measurement of the chips library (includes humidity)
+static const uint8_t TEMP_I2C_MODE_LOW = 1;  // fastest temperature only measurement
+static const uint8_t TEMP_I2C_MODE_MEDIUM = 2;
+static const uint8_t TEMP_I2C_MODE_HIGH = 3;  // most accurate temperature only measurement
+
+/*
+Renders len bytes of data as lowercase hex-string into out (which needs to hold 2 * len + 1 chars), used for all sensor IDs
+*/
+inline void tempHexEncode(const uint8_t* data, uint8_t len, char* out) {
+    static const char digits[] = "0123456789abcdef";
+    for (uint8_t i = 0; i < len; ++i) {
+        *out++ = digits[data[i] >> 4];
+        *out++ = digits[data[i] & 0x0F];
+    }
+    *out = '\0';
+}
+
+/*
+Drivers for single-chip (I2C) temperature sensors. Every driver provides:
+  SerialNumber          type holding the serial number of the chip
+  begin()               initializes the chip, returns true if it is connected
+  isConnected()         returns true if the chip is connected
+  getSN(sn)             reads the serial number of the chip
+  conversionMs(mode)    duration of a conversion in the given measurement mode
+  trigger(mode)         starts a conversion in background
+  getT(mode)            returns the temperature (in degree celsius) of the last conversion, NAN if reading failed
+
+To support a new chip add a driver and list it in NahsBricksFeatureTemp::I2CSensors
+*/
+struct TempDriverHDC1080 {
+    typedef HDC1080_SerialNumber SerialNumber;
+    static const uint8_t ADDRESS = 0x40;
+    static const uint8_t REG_TEMPERATURE = 0x00;  // pointing to it triggers a measurement
+    static const uint8_t REG_CONFIG = 0x02;
+    static const uint8_t CONFIG_MODE = 0x10;  // in MSB of config, cleared measures temperature only
+    static const uint8_t CONFIG_TRES_11BIT = 0x04;  // in MSB of config
+    static bool begin() { return HDC1080.begin(); }
+    static bool isConnected() { return HDC1080.isConnected(); }
+    static void getSN(SerialNumber sn) { HDC1080.getSN(sn); }
+    static uint8_t conversionMs(uint8_t mode) {
+        if (mode == TEMP_I2C_MODE_DEFAULT) return 15;  // temperature and humidity at 14bit each
+        if (mode == TEMP_I2C_MODE_LOW) return 4;  // temperature only at 11bit
+        return 7;  // temperature only at 14bit
+    }
+    static void trigger(uint8_t mode) {
+        if (mode == TEMP_I2C_MODE_DEFAULT) {
+            HDC1080.triggerRead();
+            return;
+        }
+        // the configuration of the chips library is kept and restored by getT() (other users of the chip rely on it)
+        if (savedConfig() < 0) {  // not yet restored if triggered twice
+            Wire.beginTransmission(ADDRESS);
+            Wire.write(REG_CONFIG);
+            Wire.endTransmission();
+            if (Wire.requestFrom(ADDRESS, (uint8_t)2) == 2) {
+                savedConfig() = Wire.read() << 8;
+                savedConfig() |= Wire.read();
+            }
+        }
+        uint8_t msb = (savedConfig() < 0) ? 0 : (savedConfig() >> 8) & ~(CONFIG_MODE | CONFIG_TRES_11BIT);
+        writeConfig((msb | ((mode == TEMP_I2C_MODE_LOW) ? CONFIG_TRES_11BIT : 0x00)) << 8);
+        Wire.beginTransmission(ADDRESS);
+        Wire.write(REG_TEMPERATURE);
+        Wire.endTransmission();
+    }
+    static float getT(uint8_t mode) {
+        if (mode == TEMP_I2C_MODE_DEFAULT) return HDC1080.getT();
+        bool read = (Wire.requestFrom(ADDRESS, (uint8_t)2) == 2);
+        uint16_t raw = 0;
+        if (read) {
+            raw = Wire.read() << 8;
+            raw |= Wire.read();
+        }
+        if (savedConfig() >= 0) writeConfig(savedConfig());
+        savedConfig() = -1;
+        if (!read) return NAN;
+        return raw * 165.0f / 65536 - 40;
+    }
+    static int32_t& savedConfig() {  // configuration register as found by trigger() until getT() restored it (-1 = nothing to restore)
+        static int32_t config = -1;
+        return config;
+    }
+    static void writeConfig(uint16_t config) {
+        Wire.beginTransmission(ADDRESS);
+        Wire.write(REG_CONFIG);
+        Wire.write(config >> 8);
+        Wire.write(config & 0xFF);
+        Wire.endTransmission();
+    }
+};
+
+struct TempDriverSHT4x {
+    typedef SHT4x_SerialNumber SerialNumber;
+    static const uint8_t ADDRESS = 0x44;
+    static const uint8_t CMD_MEASURE_LOW = 0xE0;
+    static const uint8_t CMD_MEASURE_MEDIUM = 0xF6;
+    static const uint8_t CMD_MEASURE_HIGH = 0xFD;
+    static bool begin() { return SHT4x.begin(); }
+    static bool isConnected() { return SHT4x.isConnected(); }
+    static void getSN(SerialNumber sn) { SHT4x.getSN(sn); }
+    static uint8_t conversionMs(uint8_t mode) {
+        if (mode == TEMP_I2C_MODE_LOW) return 2;  // low repeatability
+        if (mode == TEMP_I2C_MODE_MEDIUM) return 5;  // medium repeatability
+        return 9;  // high repeatability
+    }
+    static void trigger(uint8_t mode) {
+        if (mode == TEMP_I2C_MODE_DEFAULT) {
+            SHT4x.triggerRead();
+            return;
+        }
+        Wire.beginTransmission(ADDRESS);
+        if (mode == TEMP_I2C_MODE_LOW) Wire.write(CMD_MEASURE_LOW);
+        else if (mode == TEMP_I2C_MODE_MEDIUM) Wire.write(CMD_MEASURE_MEDIUM);
+        else Wire.write(CMD_MEASURE_HIGH);
+        Wire.endTransmission();
+    }
+    static float getT(uint8_t mode) {
+        if (mode == TEMP_I2C_MODE_DEFAULT) return SHT4x.getT();
+        uint8_t data[6];  // temperature, CRC, humidity, CRC
+        if (Wire.requestFrom(ADDRESS, (uint8_t)sizeof(data)) != sizeof(data)) return NAN;
+        for (uint8_t i = 0; i < sizeof(data); ++i) data[i] = Wire.read();
+        if (crc8(data, 2) != data[2]) return NAN;
+        return -45 + 175.0f * ((data[0] << 8) | data[1]) / 65535;
+    }
+    static uint8_t crc8(const uint8_t* data, uint8_t len) {  // polynomial 0x31, init 0xFF
+        uint8_t crc = 0xFF;
+        for (uint8_t i = 0; i < len; ++i) {
+            crc ^= data[i];
+            for (uint8_t b = 0; b < 8; ++b) crc = (crc & 0x80) ? (crc << 1) ^ 0x31 : (crc << 1);
+        }
+        return crc;
+    }
+};
+
+/*
+State of one single-chip sensor, serial number and correction are kept in RTCmem
+*/
+template<class Driver>
+class TempI2CSensor {
+    public:
+        typedef struct {
+            int16_t corr;  // holds correction value (in 1/128 degree celsius) if connected
+            int16_t gain;  // holds deviation of the gain from 1 (in 1/32768) if connected
+            uint8_t mode;  // measurement mode (TEMP_I2C_MODE_*)
+            typename Driver::SerialNumber SN;  // holds SN of sensor if connected
+        } _RTCdata;
+        _RTCdata* RTCdata = RTCmem.registerData<_RTCdata>();
+        bool connected = false;
+        unsigned long readyAt = 0;  // millis() when the conversion started by trigger() is finished
+        char id[2 * sizeof(typename Driver::SerialNumber) + 1];  // hex ID, rendered once per wake
+
+        bool begin() { return connected = Driver::begin(); }
+        bool recheck() { return connected = Driver::isConnected(); }
+        void initRTCdata() {
+            if (connected) Driver::getSN(RTCdata->SN);
+            else memset(RTCdata->SN, 0, sizeof(RTCdata->SN));
+            RTCdata->mode = TEMP_I2C_MODE_DEFAULT;
+        }
+        void renderID() {
+            if (connected) tempHexEncode(RTCdata->SN, sizeof(RTCdata->SN), id);
+            else id[0] = '\0';
+        }
+        void trigger() {
+            if (!connected) return;
+            Driver::trigger(RTCdata->mode);
+            readyAt = millis() + Driver::conversionMs(RTCdata->mode) + 1;  // plus 1ms as millis() only counts whole milliseconds
+        }
+        float getT() { return Driver::getT(RTCdata->mode); }
+};
+
+/*
+Compile-time list of single-chip sensors, every call is resolved at compile time (no virtual calls).
+Sensors are addressed by their index in the list
+*/
+template<class... Sensors>
+class TempSensorRegistry {
+    public:
+        static const uint8_t COUNT = 0;
+        bool begin() { return true; }
+        void recheck() {}
+        void initRTCdata() {}
+        void renderIDs() {}
+        void trigger() {}
+        bool isConnected(uint8_t) { return false; }
+        const char* getID(uint8_t) { return ""; }
+        int16_t getCorr(uint8_t) { return 0; }
+        void setCorr(uint8_t, int16_t) {}
+        int16_t getGain(uint8_t) { return 0; }
+        void setGain(uint8_t, int16_t) {}
+        uint8_t getMode(uint8_t) { return TEMP_I2C_MODE_DEFAULT; }
+        void setMode(uint8_t, uint8_t) {}
+        unsigned long getReadyAt(uint8_t) { return 0; }
+        float getT(uint8_t) { return 0; }
+};
+
+template<class Head, class... Tail>
+class TempSensorRegistry<Head, Tail...> {
+    private:
+        Head _head;
+        TempSensorRegistry<Tail...> _tail;
+
+    public:
+        static const uint8_t COUNT = 1 + sizeof...(Tail);
+
+        // returns true if all sensors are connected
+        bool begin() {
+            bool head = _head.begin();
+            return _tail.begin() && head;
+        }
+        void recheck() {
+            if (!_head.connected) _head.recheck();
+            _tail.recheck();
+        }
+        void initRTCdata() {
+            _head.initRTCdata();
+            _tail.initRTCdata();
+        }
+        void renderIDs() {
+            _head.renderID();
+            _tail.renderIDs();
+        }
+        void trigger() {
+            _head.trigger();
+            _tail.trigger();
+        }
+        bool isConnected(uint8_t index) {
+            return (index == 0) ? _head.connected : _tail.isConnected(index - 1);
+        }
+        const char* getID(uint8_t index) {
+            return (index == 0) ? _head.id : _tail.getID(index - 1);
+        }
+        int16_t getCorr(uint8_t index) {
+            return (index == 0) ? _head.RTCdata->corr : _tail.getCorr(index - 1);
+        }
+        void setCorr(uint8_t index, int16_t corr) {
+            if (index == 0) _head.RTCdata->corr = corr;
+            else _tail.setCorr(index - 1, corr);
+        }
+        int16_t getGain(uint8_t index) {
+            return (index == 0) ? _head.RTCdata->gain : _tail.getGain(index - 1);
+        }
+        void setGain(uint8_t index, int16_t gain) {
+            if (index == 0) _head.RTCdata->gain = gain;
+            else _tail.setGain(index - 1, gain);
+        }
+        uint8_t getMode(uint8_t index) {
+            return (index == 0) ? _head.RTCdata->mode : _tail.getMode(index - 1);
+        }
+        void setMode(uint8_t index, uint8_t mode) {
+            if (index == 0) _head.RTCdata->mode = mode;
+            else _tail.setMode(index - 1, mode);
+        }
+        unsigned long getReadyAt(uint8_t index) {
+            return (index == 0) ? _head.readyAt : _tail.getReadyAt(index - 1);
+        }
+        float getT(uint8_t index) {
+            return (index == 0) ? _head.getT() : _tail.getT(index - 1);
+        }
+};
+
+#endif // NAHS_BRICKS_FEATURE_TEMP_SENSORS_H
@@ -22,104 +22,211 @@ uint16_t NahsBricksFeatureTemp::getVersion() {
 Configures FSmem und RTCmem variables (prepares feature to be fully operational)
 */
 void NahsBricksFeatureTemp::begin() {
-    _oneWire.begin(_oneWirePin);
-    _DS18B20.setOneWire(&_oneWire);
-    _DS18B20.begin();
+    uint32_t startedAt = micros();
+    _begunAt = millis();
+    for (uint8_t b = 0; b < ONEWIRE_BUS_COUNT; ++b) {
+        _oneWire[b].begin(_oneWirePins[b]);
+        _DS18B20[b].setOneWire(&_oneWire[b]);
+    }
 
-    _HDC1080_connected = HDC1080.begin();
-    _SHT4x_connected = SHT4x.begin();
+    bool i2cConnected = _i2cSensors.begin();
 
-    if (!FSdata.containsKey("sCorr")) FSdata.createNestedObject("sCorr");  // dict with sensorAddr as key and sensorCorr as value
     if (!FSdata.containsKey("sPrec")) FSdata["sPrec"] = 11;  // default sensor precision
+    if (!FSdata.containsKey("sPrecS")) FSdata.createNestedObject("sPrecS");  // dict with sensorAddr as key and sensorPrecision as value (overrides sPrec)
+    if (!FSdata.containsKey("sAddr")) FSdata.createNestedArray("sAddr");  // list of sensorAddr found on last full search
+    if (FSdata.containsKey("sCorr")) _migrateCorrMap();  // corrections used to be a dict with sensorAddr as key and sensorCorr as value
+    if (!CTdata.containsKey("c")) CTdata["c"] = "";  // correction table, see _findCorrRecord
 
+    _sensorsDiscovered = false;
+    _newSensors = 0;
+    _sensorRegsRead = 0;
     if (!RTCmem.isValid()) {
-        if (!_HDC1080_connected || !_SHT4x_connected) {
+        if (!i2cConnected) {
             delay(15);
-            _HDC1080_connected = HDC1080.isConnected();
-            _SHT4x_connected = SHT4x.isConnected();
+            _i2cSensors.recheck();
         }
         RTCdata->precisionRequested = false;
         RTCdata->sensorCorrRequested = false;
+        RTCdata->timingRequested = false;
+        _resetTiming(true);
+        RTCdata->rescanRequested = false;
+        RTCdata->rescanInterval = 0;
+        RTCdata->deadband = 0;
+        RTCdata->maxSilence = 0;
+        RTCdata->wakesSinceFullReport = 0;
+        for (uint8_t i = 0; i < CHANNEL_COUNT; ++i) DBdata->lastSent[i] = NOTHING_SENT;
+        RTCdata->centiFormat = false;
+        RTCdata->compactPayload = false;
+        RTCdata->ackedTableHash = 0;
+        RTCdata->alarmMode = false;
+        RTCdata->filterMode = FILTER_OFF;
+        RTCdata->filterParam = 3;
+#if TEMP_FILTERING
+        _resetFilters();
+#endif
+        RTCdata->adaptivePrecision = false;
+        RTCdata->prearmConversion = false;
+        RTCdata->conversionPrearmed = false;
+        RTCdata->batchSize = 0;
+        RTCdata->batchInterval = 0;
+        RTCdata->batchCount = 0;
+        RTCdata->wakesSinceFlush = 0;
         RTCdata->sensorPrecision = FSdata["sPrec"].as<uint8_t>();
-        RTCdata->sensorCount = min(_DS18B20.getDeviceCount(), (uint8_t)MAX_TEMP_SENSORS_COUNT);
-
-        for (uint8_t i = 0; i < MAX_TEMP_SENSORS_COUNT; i++) {
-            if (i < RTCdata->sensorCount) {
-                if (i < 4) _DS18B20.getAddress(SAdata1->sensorAddr[i], i);
-                else _DS18B20.getAddress(SAdata2->sensorAddr[i], i);
-                String addr = _deviceAddrToString(i);
-                if (FSdata["sCorr"].as<JsonObject>().containsKey(addr)) {
-                    SCdata->sensorCorr[i] = FSdata["sCorr"].as<JsonObject>()[addr].as<float>();
-                }
-                else SCdata->sensorCorr[i] = 0;
-            }
-            else {
-                if (i < 4) memset(SAdata1->sensorAddr[i], 0, sizeof(SAdata1->sensorAddr[i]));
-                else memset(SAdata2->sensorAddr[i], 0, sizeof(SAdata2->sensorAddr[i]));
-                SCdata->sensorCorr[i] = 0;
-            }
-        }
 
-        if (_HDC1080_connected) {
-            HDC1080.getSN(RTCdata->HDC1080SN);
-            String sn = HDC1080.snToString(RTCdata->HDC1080SN);
-            if (FSdata["sCorr"].as<JsonObject>().containsKey(sn)) {
-                RTCdata->HDC1080Corr = FSdata["sCorr"].as<JsonObject>()[sn].as<float>();
-            }
-            else RTCdata->HDC1080Corr = 0;
-        }
-        else {
-            memset(RTCdata->HDC1080SN, 0, sizeof(RTCdata->HDC1080SN));
-            RTCdata->HDC1080Corr = 0;
-        }
+        _i2cSensors.initRTCdata();
 
-        if(_SHT4x_connected) {
-            SHT4x.getSN(SHTdata->SHT4xSN);
-            String sn = SHT4x.snToString(SHTdata->SHT4xSN);
-            if (FSdata["sCorr"].as<JsonObject>().containsKey(sn)) {
-                SHTdata->SHT4xCorr = FSdata["sCorr"].as<JsonObject>()[sn].as<float>();
-            }
-            else SHTdata->SHT4xCorr = 0;
-        }
-        else {
-            memset(SHTdata->SHT4xSN, 0, sizeof(SHTdata->SHT4xSN));
-            SHTdata->SHT4xCorr = 0;
-        }
+        RTCdata->sensorsAdded = 0;
+        RTCdata->sensorsRemoved = 0;
+
+        _discoverSensors();
+    }
+    else if (RTCdata->rescanRequested || (RTCdata->rescanInterval > 0 && RTCdata->wakesSinceScan >= RTCdata->rescanInterval)) {
+        RTCdata->rescanRequested = false;
+        _updateSensors();
+    }
+    else {
+        if (RTCdata->wakesSinceScan < UINT16_MAX) ++RTCdata->wakesSinceScan;
+        _unpackSensorAddrs();
     }
+
+    _renderSensorIDs();
+    _tableHash = _calcTableHash();
+#if TEMP_BATCH_BUFFER_SLOTS > 0
+    if (RTCdata->batchCount > 0 && BTdata->tableHash != _tableHash) {  // a single-chip sensor came or went, buffered samples do not match the channels anymore
+        RTCdata->batchCount = 0;
+        RTCdata->wakesSinceFlush = 0;
+    }
+#endif
+
+    if (_sensorsDiscovered) {
+        for (uint8_t i = 0; i < MAX_TEMP_SENSORS_COUNT; ++i) DBdata->lastSent[i] = NOTHING_SENT;  // sensors might have moved to other indexes
+#if TEMP_FILTERING
+        for (uint8_t i = 0; i < MAX_TEMP_SENSORS_COUNT; ++i) FLdata->samples[i] = 0;
+#endif
+#if TEMP_TELEMETRY
+        for (uint8_t i = 0; i < MAX_TEMP_SENSORS_COUNT; ++i) TMdata->readErrors[i] = 0;
+#endif
+        RTCdata->batchCount = 0;  // buffered samples do not match the sensors anymore
+        RTCdata->wakesSinceFlush = 0;
+        _loadSensorPrecisions();
+        for (uint8_t ch = 0; ch < CHANNEL_COUNT; ch++) _loadChannelCalibration(ch);
+    }
+
+    _recordTiming(TIMING_BEGIN, micros() - startedAt);
 }
 
 /*
 Starts background processes like fetching data from other components
 */
 void NahsBricksFeatureTemp::start() {
-    // if brick just started up, configure the correct precision and do a dummy reading
-    if(!RTCmem.isValid()) {
-        _transmitPrecisionToSensors(false);
+    uint32_t startedAt = micros();
+
+    // if sensors have just been discovered (or added), configure the correct precision (where it differs)
+    if(_sensorsDiscovered) {
+        _transmitPrecisionToSensors();
+    }
+    else if (_newSensors) {
+        _transmitPrecisionToSensors(_newSensors);
     }
 
-    // Start the Temp-Conversion in Background as this takes some time
-    _DS18B20.setWaitForConversion(false);
-    _DS18B20.requestTemperatures();
+    // Start the Temp-Conversion in Background as this takes some time (unless it was already started before deep sleep)
+    if (RTCdata->conversionPrearmed && !_sensorsDiscovered) _DS18B20ReadyAt = millis();
+    else _startConversion();
+    RTCdata->conversionPrearmed = false;
 
-    // Trigger Conversion of HDC1080 in Background if connected
-    if (_HDC1080_connected) {
-        HDC1080.triggerRead();
-    }
+    // Trigger Conversion of all connected single-chip sensors in Background
+    _i2cSensors.trigger();
 
-    // Trigger Conversion of SHT4x in Background if connected
-    if (_SHT4x_connected) {
-        SHT4x.triggerRead();
-    }
+    _recordTiming(TIMING_START, micros() - startedAt);
 }
 
 /*
 Adds data to outgoing json, that is send to BrickServer
 */
 void NahsBricksFeatureTemp::deliver(JsonDocument* out_json) {
+    uint32_t startedAt = micros();
+
+    // in batching mode nothing is delivered on wakes that only buffer readings (the OS may keep the radio off),
+    // so requested data and topology changes are kept until the batch is flushed
+    bool flush = isBatchFlushDue();
+    if (flush) _deliverRequested(out_json);
+
+    // wait for temperature conversion to complete and read all sensors
+    int32_t values[CHANNEL_COUNT];
+    uint32_t waitStartedAt = micros();
+    _readChannels(values);
+    uint32_t waitDuration = micros() - waitStartedAt;
+    _recordTiming(TIMING_WAIT, waitDuration);
+#if TEMP_ADAPTIVE_PRECISION
+    if (RTCdata->adaptivePrecision) _adaptPrecision(values);
+#endif
+#if TEMP_FILTERING
+    if (RTCdata->filterMode != FILTER_OFF) _filterReadings(values);
+#endif
+
+    // in batching mode the readings are only buffered in RTCmem until the batch is due to be flushed
+#if TEMP_BATCH_BUFFER_SLOTS > 0
+    if (!flush) {
+        _bufferReadings(values);
+        return;
+    }
+    if (RTCdata->batchCount > 0) _flushBatch(out_json);
+#endif
+    RTCdata->batchCount = 0;
+    RTCdata->wakesSinceFlush = 0;
+
+    // once BrickServer acknowledged the channel table, only values are delivered (as tv in channel order) instead of ID and value pairs
+    // (compact payload is opt-in with feedback key tcp, the table is only delivered while it is not acknowledged)
+    bool compact = _isCompact();
+    if (RTCdata->compactPayload) out_json->operator[]("th").set(_tableHash);
+    if (RTCdata->compactPayload && !compact) {
+        JsonArray ti_array = out_json->createNestedArray("ti");
+        for (uint8_t ch = 0; ch < CHANNEL_COUNT; ++ch) {
+            if (_isChannelActive(ch)) ti_array.add(_getChannelID(ch));
+        }
+    }
+
+    // deliver the temperatures
+    const char* arrayKey = compact ? "tv" : "t";
+    JsonArray t_array;
+    if (out_json->containsKey(arrayKey))
+        t_array = out_json->operator[](arrayKey).as<JsonArray>();
+    else
+        t_array = out_json->createNestedArray(arrayKey);
+
+    // with a deadband configured only changed values are delivered, unless a full report is due
+    bool fullReport = (RTCdata->deadband == 0 || (RTCdata->maxSilence > 0 && RTCdata->wakesSinceFullReport >= RTCdata->maxSilence));
+    if (fullReport) RTCdata->wakesSinceFullReport = 0;
+    else if (RTCdata->wakesSinceFullReport < UINT16_MAX) ++RTCdata->wakesSinceFullReport;
+
+    for (uint8_t ch = 0; ch < CHANNEL_COUNT; ++ch) {
+        bool force = fullReport || (RTCdata->alarmMode && ch < I2C_CHANNEL);  // sensors outside of their thresholds are always delivered
+        if (_isChannelActive(ch)) _addReading(t_array, compact ? nullptr : _getChannelID(ch), values[ch], ch, force);
+    }
+
+    _recordTiming(TIMING_JSON, micros() - startedAt - waitDuration);
+}
+
+/*
+Helper to add data requested by BrickServer (precision, calibration, timing telemetry) and topology changes to outgoing json
+*/
+void NahsBricksFeatureTemp::_deliverRequested(JsonDocument* out_json) {
     // deliver sensors precision if requested
     if (RTCdata->precisionRequested) {
         RTCdata->precisionRequested = false;
         out_json->operator[]("p").set(RTCdata->sensorPrecision);
+
+        JsonArray ps_array;
+        if (out_json->containsKey("tps"))
+            ps_array = out_json->operator[]("tps").as<JsonArray>();
+        else
+            ps_array = out_json->createNestedArray("tps");
+        for (uint8_t i = 0; i < RTCdata->sensorCount; ++i) {
+            JsonArray s_array = ps_array.createNestedArray();
+            s_array.add(_getSensorID(i));
+            s_array.add(_getPrecision(i));
+            s_array.add(_getActivePrecision(i));
+        }
     }
 
     // deliver sensors correction values if requested
@@ -132,45 +239,60 @@ void NahsBricksFeatureTemp::deliver(JsonDocument* out_json) {
         else
             c_array = out_json->createNestedArray("c");
 
-        for (uint8_t i = 0; i < RTCdata->sensorCount; ++i) {
-            JsonArray s_array = c_array.createNestedArray();
-            s_array.add(_deviceAddrToString(i));
-            s_array.add(SCdata->sensorCorr[i]);
-        }
-        if (_HDC1080_connected) {
-            JsonArray s_array = c_array.createNestedArray();
-            s_array.add(HDC1080.snToString(RTCdata->HDC1080SN));
-            s_array.add(RTCdata->HDC1080Corr);
-        }
-        if (_SHT4x_connected) {
+        for (uint8_t ch = 0; ch < CHANNEL_COUNT; ++ch) {
+            if (!_isChannelActive(ch)) continue;
             JsonArray s_array = c_array.createNestedArray();
-            s_array.add(SHT4x.snToString(SHTdata->SHT4xSN));
-            s_array.add(SHTdata->SHT4xCorr);
+            s_array.add(_getChannelID(ch));
+            s_array.add(_rawToC(_getChannelCorr(ch)));
         }
-    }
 
-    // wait for temperature conversion to complete and deliver the temperatures
-    JsonArray t_array;
-    if (out_json->containsKey("t"))
-        t_array = out_json->operator[]("t").as<JsonArray>();
-    else
-        t_array = out_json->createNestedArray("t");
+        JsonArray g_array;
+        if (out_json->containsKey("tg"))
+            g_array = out_json->operator[]("tg").as<JsonArray>();
+        else
+            g_array = out_json->createNestedArray("tg");
 
-    while(!_DS18B20.isConversionComplete()) delay(1);
-    for (uint8_t i = 0; i < RTCdata->sensorCount; ++i) {
-        JsonArray s_array = t_array.createNestedArray();
-        s_array.add(_deviceAddrToString(i));
-        s_array.add(_getTempC(i) + SCdata->sensorCorr[i]);
+        for (uint8_t ch = 0; ch < CHANNEL_COUNT; ++ch) {
+            if (!_isChannelActive(ch)) continue;
+            JsonArray s_array = g_array.createNestedArray();
+            s_array.add(_getChannelID(ch));
+            s_array.add(_gainToFactor(_getChannelGain(ch)));
+        }
     }
-    if (_HDC1080_connected) {
-        JsonArray s_array = t_array.createNestedArray();
-        s_array.add(HDC1080.snToString(RTCdata->HDC1080SN));
-        s_array.add(HDC1080.getT() + RTCdata->HDC1080Corr);
+
+    // deliver changes of the topology (number of added and removed sensors)
+    if (RTCdata->sensorsAdded > 0 || RTCdata->sensorsRemoved > 0) {
+        JsonArray tx_array = out_json->createNestedArray("tx");
+        tx_array.add(RTCdata->sensorsAdded);
+        tx_array.add(RTCdata->sensorsRemoved);
+        RTCdata->sensorsAdded = 0;
+        RTCdata->sensorsRemoved = 0;
     }
-    if (_SHT4x_connected) {
-        JsonArray s_array = t_array.createNestedArray();
-        s_array.add(SHT4x.snToString(SHTdata->SHT4xSN));
-        s_array.add(SHT4x.getT() + SHTdata->SHT4xCorr);
+
+    // deliver timing telemetry if requested ([min, avg, max] in microseconds per phase, then error counters and failed reads per sensor)
+    if (RTCdata->timingRequested) {
+        RTCdata->timingRequested = false;
+#if TEMP_TELEMETRY
+        JsonArray tt_array = out_json->createNestedArray("tt");
+        for (uint8_t p = 0; p < TIMING_PHASE_COUNT; ++p) {
+            JsonArray p_array = tt_array.createNestedArray();
+            p_array.add((TMdata->phase[p].min == UINT32_MAX) ? 0 : TMdata->phase[p].min);
+            p_array.add(TMdata->phase[p].avg);
+            p_array.add(TMdata->phase[p].max);
+        }
+        JsonArray te_array = out_json->createNestedArray("te");
+        te_array.add(TMdata->busErrors);
+        te_array.add(TMdata->crcErrors);
+        te_array.add(TMdata->powerOnErrors);
+        JsonArray tre_array = out_json->createNestedArray("tre");
+        for (uint8_t ch = 0; ch < CHANNEL_COUNT; ++ch) {
+            if (!_isChannelActive(ch) || TMdata->readErrors[ch] == 0) continue;
+            JsonArray s_array = tre_array.createNestedArray();
+            s_array.add(_getChannelID(ch));
+            s_array.add(TMdata->readErrors[ch]);
+        }
+        _resetTiming(false);
+#endif
     }
 }
 
@@ -178,15 +300,126 @@ void NahsBricksFeatureTemp::deliver(JsonDocument* out_json) {
 Processes feedback coming from BrickServer
 */
 void NahsBricksFeatureTemp::feedback(JsonDocument* in_json) {
+    // check if a rescan of the OneWire bus is requested or a new interval for periodic rescans is delivered
+    if (in_json->containsKey("trs")) RTCdata->rescanRequested = in_json->operator[]("trs").as<bool>();
+    if (in_json->containsKey("tri")) RTCdata->rescanInterval = in_json->operator[]("tri").as<uint16_t>();
+
+    // check if new deadband (in degree celsius) or max number of wakes without full report is delivered
+    if (in_json->containsKey("tdb")) {
+        float db = in_json->operator[]("tdb").as<float>();
+        if (db >= 0 && db < 100) RTCdata->deadband = (uint16_t)(db * 100 + 0.5);
+    }
+    if (in_json->containsKey("tms")) RTCdata->maxSilence = in_json->operator[]("tms").as<uint16_t>();
+
+    // check if new format for the t array is delivered (0 = float in degree celsius, 1 = integer in 1/100 degree celsius)
+    if (in_json->containsKey("tf")) RTCdata->centiFormat = (in_json->operator[]("tf").as<uint8_t>() == 1);
+
+#if TEMP_FILTERING
+    // check if new filter mode (0 = off, 1 = median, 2 = EMA) or parameter (readings for median, weight shift for EMA) is delivered
+    if (in_json->containsKey("tfm") || in_json->containsKey("tfn")) {
+        uint8_t mode = in_json->containsKey("tfm") ? in_json->operator[]("tfm").as<uint8_t>() : RTCdata->filterMode;
+        uint8_t param = in_json->containsKey("tfn") ? in_json->operator[]("tfn").as<uint8_t>() : RTCdata->filterParam;
+        if (mode == FILTER_MEDIAN) param = constrain(param, 2, FILTER_MEDIAN_MAX);
+        else if (mode == FILTER_EMA) param = constrain(param, 1, FILTER_EMA_MAX_SHIFT);
+        if (mode <= FILTER_EMA && (mode != RTCdata->filterMode || param != RTCdata->filterParam)) {
+            RTCdata->filterMode = mode;
+            RTCdata->filterParam = param;
+            _resetFilters();
+        }
+    }
+#endif
+
+    // check if new batch size (samples per flush) or flush interval (in wakes) is delivered,
+    // a change drops the buffered samples as their age is derived from the sampling step
+    if (in_json->containsKey("tbs") || in_json->containsKey("tbf")) {
+        uint8_t size = in_json->containsKey("tbs") ? in_json->operator[]("tbs").as<uint8_t>() : RTCdata->batchSize;
+        uint8_t interval = in_json->containsKey("tbf") ? in_json->operator[]("tbf").as<uint8_t>() : RTCdata->batchInterval;
+        if (size != RTCdata->batchSize || interval != RTCdata->batchInterval) {
+            RTCdata->batchSize = size;
+            RTCdata->batchInterval = interval;
+            RTCdata->batchCount = 0;
+            RTCdata->wakesSinceFlush = 0;
+        }
+    }
+
     // check if new sensorPrecision value is delivered
     if (in_json->containsKey("p")) {
         uint8_t p = in_json->operator[]("p").as<uint8_t>();
         if (p >= 9 and p <=12) {
             RTCdata->sensorPrecision = p;
-            _transmitPrecisionToSensors(true);
+            _loadSensorPrecisions();
+            _transmitPrecisionToSensors();
+        }
+    }
+
+    // check if precisions for single sensors are delivered (list of [sensorAddr, precision], precision 0 removes the override)
+    if (in_json->containsKey("tps")) {
+        JsonObject sPrecS = FSdata["sPrecS"].as<JsonObject>();
+        for (JsonVariant entry : in_json->operator[]("tps").as<JsonArray>()) {
+            String addr = entry[0].as<String>();
+            uint8_t p = entry[1].as<uint8_t>();
+            if (p == 0 && sPrecS.containsKey(addr)) sPrecS.remove(addr);
+            else if (p >= 9 && p <= 12) sPrecS[addr] = p;
+        }
+        _loadSensorPrecisions();
+        _transmitPrecisionToSensors();
+    }
+
+    // check if calibrations for single sensors are delivered (list of [sensorAddr, gain, correction])
+    if (in_json->containsKey("tg")) {
+        JsonArray tg = in_json->operator[]("tg").as<JsonArray>();
+        if (_editCorrTable(tg.size())) {
+            for (JsonVariant entry : tg) {
+                int16_t gain;
+                int16_t corr;
+                if (!_factorToGain(entry[1].as<float>(), &gain) || !_cToCorr(entry[2].as<float>(), &corr)) continue;
+                _setCalibration(entry[0].as<String>().c_str(), corr, gain);
+            }
+            _saveCorrTable();
         }
     }
 
+    // check if alarm thresholds for single DS18B20 sensors are delivered (list of [sensorAddr, low, high] in degree celsius)
+    if (in_json->containsKey("tal")) {
+        for (JsonVariant entry : in_json->operator[]("tal").as<JsonArray>()) {
+            _setAlarmThresholds(entry[0].as<String>().c_str(), entry[1].as<int8_t>(), entry[2].as<int8_t>());
+        }
+    }
+
+    // check if alarm mode (only sensors outside of their thresholds are read and delivered) is switched on or off
+    if (in_json->containsKey("tam")) RTCdata->alarmMode = in_json->operator[]("tam").as<bool>();
+
+    // check if measurement modes for single-chip sensors are delivered (list of [sensorAddr, mode], 0 = library default, 1 to 3 = low to high, temperature only)
+    if (in_json->containsKey("tim")) {
+        for (JsonVariant entry : in_json->operator[]("tim").as<JsonArray>()) {
+            int8_t channel = _findChannel(entry[0].as<String>().c_str());
+            uint8_t mode = entry[1].as<uint8_t>();
+            if (channel >= I2C_CHANNEL && mode <= TEMP_I2C_MODE_HIGH) _i2cSensors.setMode(channel - I2C_CHANNEL, mode);
+        }
+    }
+
+    // check if compact payload is switched on or off (switching it on or off forgets the acknowledged channel table)
+    if (in_json->containsKey("tcp")) {
+        bool compactPayload = in_json->operator[]("tcp").as<bool>();
+        if (compactPayload != RTCdata->compactPayload) RTCdata->ackedTableHash = 0;
+        RTCdata->compactPayload = compactPayload;
+    }
+
+    // check if BrickServer acknowledges the channel table (by it's hash th) to receive compact payload
+    if (in_json->containsKey("th")) RTCdata->ackedTableHash = in_json->operator[]("th").as<uint32_t>();
+
+    // check if pre-armed conversion (started in end() to be ready at next wake) is switched on or off
+    if (in_json->containsKey("tpc")) RTCdata->prearmConversion = in_json->operator[]("tpc").as<bool>();
+
+#if TEMP_ADAPTIVE_PRECISION
+    // check if adaptive precision is switched on or off
+    if (in_json->containsKey("tpa")) {
+        bool adaptive = in_json->operator[]("tpa").as<bool>();
+        if (RTCdata->adaptivePrecision && !adaptive) _restorePrecisions();
+        RTCdata->adaptivePrecision = adaptive;
+    }
+#endif
+
     // evaluate requests
     if (in_json->containsKey("r")) {
         for (JsonVariant value : in_json->operator[]("r").as<JsonArray>()) {
@@ -197,6 +430,9 @@ void NahsBricksFeatureTemp::feedback(JsonDocument* in_json) {
                 case 6:
                     RTCdata->precisionRequested = true;
                     break;
+                case TIMING_REQUEST:
+                    RTCdata->timingRequested = true;
+                    break;
             }
         }
     }
@@ -206,6 +442,11 @@ void NahsBricksFeatureTemp::feedback(JsonDocument* in_json) {
 Finalizes feature (closes stuff)
 */
 void NahsBricksFeatureTemp::end() {
+    // pre-arm the conversion for the next wake, externally powered sensors convert during deep sleep
+    if (RTCdata->prearmConversion && RTCdata->parasiteBuses == 0 && RTCdata->sensorCount > 0) {
+        _startConversion();
+        RTCdata->conversionPrearmed = true;
+    }
 }
 
 /*
@@ -216,31 +457,99 @@ void NahsBricksFeatureTemp::printRTCdata() {
     SerHelp.printlnBool(RTCdata->precisionRequested);
     Serial.print("  sensorCorrRequested: ");
     SerHelp.printlnBool(RTCdata->sensorCorrRequested);
+    Serial.print("  timingRequested: ");
+    SerHelp.printlnBool(RTCdata->timingRequested);
+#if TEMP_TELEMETRY
+    Serial.println("  timing min/avg/max (us): ");
+    const char* phaseNames[TIMING_PHASE_COUNT] = {"begin", "search", "start", "wait", "json"};
+    for (uint8_t p = 0; p < TIMING_PHASE_COUNT; ++p) {
+        Serial.print("    ");
+        Serial.print(phaseNames[p]);
+        Serial.print(": ");
+        Serial.print((TMdata->phase[p].min == UINT32_MAX) ? 0 : TMdata->phase[p].min);
+        Serial.print("/");
+        Serial.print(TMdata->phase[p].avg);
+        Serial.print("/");
+        Serial.println(TMdata->phase[p].max);
+    }
+    Serial.print("  busErrors: ");
+    Serial.println(TMdata->busErrors);
+    Serial.print("  crcErrors: ");
+    Serial.println(TMdata->crcErrors);
+    Serial.print("  powerOnErrors: ");
+    Serial.println(TMdata->powerOnErrors);
+#endif
+    Serial.print("  rescanRequested: ");
+    SerHelp.printlnBool(RTCdata->rescanRequested);
+    Serial.print("  rescanInterval: ");
+    Serial.println(RTCdata->rescanInterval);
+    Serial.print("  wakesSinceScan: ");
+    Serial.println(RTCdata->wakesSinceScan);
+    Serial.print("  parasiteBuses: ");
+    Serial.println(RTCdata->parasiteBuses, BIN);
+    Serial.print("  sensorsAdded: ");
+    Serial.println(RTCdata->sensorsAdded);
+    Serial.print("  sensorsRemoved: ");
+    Serial.println(RTCdata->sensorsRemoved);
+    Serial.print("  deadband: ");
+    Serial.println(RTCdata->deadband / 100.0);
+    Serial.print("  maxSilence: ");
+    Serial.println(RTCdata->maxSilence);
+    Serial.print("  wakesSinceFullReport: ");
+    Serial.println(RTCdata->wakesSinceFullReport);
+    Serial.print("  centiFormat: ");
+    SerHelp.printlnBool(RTCdata->centiFormat);
+    Serial.print("  alarmMode: ");
+    SerHelp.printlnBool(RTCdata->alarmMode);
+    Serial.print("  compactPayload: ");
+    SerHelp.printlnBool(RTCdata->compactPayload);
+    Serial.print("  ackedTableHash: ");
+    Serial.println(RTCdata->ackedTableHash);
+    Serial.print("  filterMode: ");
+    Serial.println(RTCdata->filterMode);
+    Serial.print("  filterParam: ");
+    Serial.println(RTCdata->filterParam);
+    Serial.print("  batchSize: ");
+    Serial.println(RTCdata->batchSize);
+    Serial.print("  batchInterval: ");
+    Serial.println(RTCdata->batchInterval);
+    Serial.print("  batchCount: ");
+    Serial.println(RTCdata->batchCount);
+    Serial.print("  wakesSinceFlush: ");
+    Serial.println(RTCdata->wakesSinceFlush);
     Serial.print("  sensorPrecision: ");
     Serial.println(RTCdata->sensorPrecision);
+    Serial.print("  prearmConversion: ");
+    SerHelp.printlnBool(RTCdata->prearmConversion);
+    Serial.print("  conversionPrearmed: ");
+    SerHelp.printlnBool(RTCdata->conversionPrearmed);
+    Serial.print("  adaptivePrecision: ");
+    SerHelp.printlnBool(RTCdata->adaptivePrecision);
     Serial.print("  sensorCount: ");
     Serial.println(RTCdata->sensorCount);
-    Serial.println("  sensor (correction): ");
-    if (_HDC1080_connected) {
+    Serial.println("  sensor (correction, gain): ");
+    for (uint8_t k = 0; k < I2CSensors::COUNT; ++k) {
+        if (!_i2cSensors.isConnected(k)) continue;
         Serial.print("    ");
-        Serial.print(HDC1080.snToString(RTCdata->HDC1080SN));
+        Serial.print(_i2cSensors.getID(k));
         Serial.print(" (");
-        Serial.print(RTCdata->HDC1080Corr);
-        Serial.println(")");
-    }
-    if (_SHT4x_connected) {
-        Serial.print("    ");
-        Serial.print(SHT4x.snToString(SHTdata->SHT4xSN));
-        Serial.print(" (");
-        Serial.print(SHTdata->SHT4xCorr);
-        Serial.println(")");
+        Serial.print(_rawToC(_i2cSensors.getCorr(k)));
+        Serial.print(", ");
+        Serial.print(_gainToFactor(_i2cSensors.getGain(k)), 5);
+        Serial.print(") mode: ");
+        Serial.println(_i2cSensors.getMode(k));
     }
     for (uint8_t i = 0; i < RTCdata->sensorCount; ++i) {
         Serial.print("    ");
-        Serial.print(_deviceAddrToString(i));
+        Serial.print(_getSensorID(i));
         Serial.print(" (");
-        Serial.print(SCdata->sensorCorr[i]);
-        Serial.println(")");
+        Serial.print(_rawToC(SCdata->sensorCorr[i]));
+        Serial.print(", ");
+        Serial.print(_gainToFactor(SCdata->sensorGain[i]), 5);
+        Serial.print(") precision: ");
+        Serial.print(_getPrecision(i));
+        Serial.print(" active: ");
+        Serial.println(_getActivePrecision(i));
     }
 }
 
@@ -250,12 +559,34 @@ Prints the features FSdata in a formatted way to Serial (used for brickSetup)
 void NahsBricksFeatureTemp::printFSdata() {
     Serial.print("  defaultSensorPrecision: ");
     Serial.println(FSdata["sPrec"].as<uint8_t>());
-    Serial.println("  default sensor corrections:");
-    for (JsonPair kv : FSdata["sCorr"].as<JsonObject>()) {
+    Serial.println("  default sensor corrections (correction, gain):");
+    const char* table = _corrTable();
+    for (int16_t r = 0; r < (int16_t)(strlen(table) / CORR_RECORD_CHARS); ++r) {
+        Serial.print("    ");
+        for (uint8_t c = 0; c < CORR_KEY_CHARS && table[r * CORR_RECORD_CHARS + c] != '-'; ++c) Serial.print(table[r * CORR_RECORD_CHARS + c]);
+        Serial.print(": ");
+        Serial.print(_rawToC(_getCorrRecord(r)));
+        Serial.print(", ");
+        Serial.println(_gainToFactor(_getGainRecord(r)), 5);
+    }
+    Serial.println("  sensor precisions:");
+    for (JsonPair kv : FSdata["sPrecS"].as<JsonObject>()) {
         Serial.print("    ");
         Serial.print(kv.key().c_str());
         Serial.print(": ");
-        Serial.println(kv.value().as<float>());
+        Serial.println(kv.value().as<uint8_t>());
+    }
+    Serial.println("  sensors found on last full search:");
+    uint8_t bus = 0;
+    for (JsonVariant busAddrs : FSdata["sAddr"].as<JsonArray>()) {
+        for (JsonVariant addr : busAddrs.as<JsonArray>()) {
+            Serial.print("    ");
+            Serial.print(addr.as<const char*>());
+            Serial.print(" (bus ");
+            Serial.print(bus);
+            Serial.println(")");
+        }
+        ++bus;
     }
 }
 
@@ -287,6 +618,12 @@ void NahsBricksFeatureTemp::brickSetupHandover() {
             case 6:
                 _deleteDefaultCorr();
                 break;
+            case 7:
+                _setTwoPointCalibration();
+                break;
+            case 8:
+                _bulkCalibration();
+                break;
             case 9:
                 Serial.println("Returning to MainMenu!");
                 return;
@@ -300,254 +637,1628 @@ void NahsBricksFeatureTemp::brickSetupHandover() {
 }
 
 /*
-Brick-Specific helper to set pin where sensors are connected
+Brick-Specific helper to set pin where sensors are connected (bus selects the OneWire bus if more than one is used)
 */
-void NahsBricksFeatureTemp::setSensorsPin(uint8_t pin) {
-    _oneWirePin = pin;
+void NahsBricksFeatureTemp::setSensorsPin(uint8_t pin, uint8_t bus) {
+    if (bus < ONEWIRE_BUS_COUNT) _oneWirePins[bus] = pin;
 }
 
 /*
-Helper to convert a sensor address (identified by index in RTCmem) to a String
+Returns true if all conversions started in start() are finished and deliver() would not need to wait
 */
-String NahsBricksFeatureTemp::_deviceAddrToString(uint8_t sensor_index) {
-    if (sensor_index < 4) return _deviceAddrToString(SAdata1->sensorAddr[sensor_index]);
-    else return _deviceAddrToString(SAdata2->sensorAddr[sensor_index]);
+bool NahsBricksFeatureTemp::isReady() {
+    return msUntilReady() == 0;
 }
 
 /*
-Helper to convert a sensor's DeviceAddress to a String
+Returns the number of milliseconds until all conversions started in start() are finished
 */
-String NahsBricksFeatureTemp::_deviceAddrToString(DeviceAddress deviceAddress) {
-    String str = "";
-    for (uint8_t i = 0; i < 8; ++i) {
-        if (deviceAddress[i] < 16 ) str += String(0, HEX);
-        str += String(deviceAddress[i], HEX);
+uint32_t NahsBricksFeatureTemp::msUntilReady() {
+    uint32_t remaining = _msUntil(_DS18B20ReadyAt);
+    for (uint8_t k = 0; k < I2CSensors::COUNT; ++k) {
+        if (_i2cSensors.isConnected(k)) remaining = max(remaining, _msUntil(_i2cSensors.getReadyAt(k)));
     }
-    return str;
+    return remaining;
 }
 
 /*
-Helper to fetch the temperature of a sensor (identified by index in RTCmem)
+Helper to fill the sensor addresses in RTCmem. If all sensors of the last full search (stored in FSdata)
+still answer, these are used. Otherwise a full search over all OneWire buses is done.
 */
-float NahsBricksFeatureTemp::_getTempC(uint8_t sensor_index) {
-    if (sensor_index < 4) return _DS18B20.getTempC(SAdata1->sensorAddr[sensor_index]);
-    else return _DS18B20.getTempC(SAdata2->sensorAddr[sensor_index]);
+void NahsBricksFeatureTemp::_discoverSensors() {
+    uint32_t startedAt = micros();
+    _sensorsDiscovered = true;
+    RTCdata->wakesSinceScan = 0;
+    _checkPowerSupply();
+
+    if (!_loadInventory()) {
+        _searchSensors();
+        _storeInventory();
+    }
+    _recordTiming(TIMING_SEARCH, micros() - startedAt);
 }
 
 /*
-Helper to configure the precision of sensors
+Helper to do a full search over all OneWire buses and patch only the RTCmem slots of sensors that were added, removed
+or moved to another index. Remaining sensors keep their state (correction, precision, deadband and filter),
+added ones get their state loaded and are configured in start(). Changes are delivered as tx.
 */
-void NahsBricksFeatureTemp::_transmitPrecisionToSensors(bool inBackground) {
-    _DS18B20.setResolution(RTCdata->sensorPrecision);
-    _DS18B20.setWaitForConversion(!inBackground);
-    _DS18B20.requestTemperatures();  // Request the temperatures once to be dumped, as the first reading allways returns 85C
+void NahsBricksFeatureTemp::_updateSensors() {
+    uint32_t startedAt = micros();
+    RTCdata->wakesSinceScan = 0;
+    _unpackSensorAddrs();
+    uint8_t oldCount = RTCdata->sensorCount;
+    DeviceAddress oldAddrs[MAX_TEMP_SENSORS_COUNT];
+    memcpy(oldAddrs, _sensorAddrs, sizeof(oldAddrs));
+    _SCdata oldSC = *SCdata;
+    _PRdata oldPR = *PRdata;
+    _DBdata oldDB = *DBdata;
+#if TEMP_FILTERING
+    _FLdata oldFL = *FLdata;
+#endif
+#if TEMP_TELEMETRY
+    _TMdata oldTM = *TMdata;
+#endif
+
+    _checkPowerSupply();
+    _searchSensors();
+    _renderSensorIDs();
+
+    uint8_t kept = 0;
+    bool moved = false;
+    for (uint8_t i = 0; i < RTCdata->sensorCount; ++i) {
+        uint8_t old = 0;
+        while (old < oldCount && memcmp(oldAddrs[old], _getSensorAddr(i), sizeof(DeviceAddress)) != 0) ++old;
+        if (old < oldCount) {
+            ++kept;
+            if (old != i) moved = true;
+            SCdata->sensorCorr[i] = oldSC.sensorCorr[old];
+            SCdata->sensorGain[i] = oldSC.sensorGain[old];
+            PRdata->precision[i] = oldPR.precision[old];
+#if TEMP_ADAPTIVE_PRECISION
+            PRdata->lastReading[i] = oldPR.lastReading[old];
+#endif
+            DBdata->lastSent[i] = oldDB.lastSent[old];
+#if TEMP_FILTERING
+            FLdata->channel[i] = oldFL.channel[old];
+            FLdata->samples[i] = oldFL.samples[old];
+#endif
+#if TEMP_TELEMETRY
+            TMdata->readErrors[i] = oldTM.readErrors[old];
+#endif
+        }
+        else {
+            _newSensors |= (uint64_t)1 << i;
+            _loadChannelCalibration(i);
+            _loadSensorPrecision(i);
+            DBdata->lastSent[i] = NOTHING_SENT;
+#if TEMP_FILTERING
+            FLdata->samples[i] = 0;
+#endif
+#if TEMP_TELEMETRY
+            TMdata->readErrors[i] = 0;
+#endif
+        }
+    }
+
+    uint8_t added = RTCdata->sensorCount - kept;
+    uint8_t removed = oldCount - kept;
+    if (added > 0 || removed > 0) {
+        RTCdata->sensorsAdded = min(RTCdata->sensorsAdded + added, UINT8_MAX);
+        RTCdata->sensorsRemoved = min(RTCdata->sensorsRemoved + removed, UINT8_MAX);
+        _storeInventory();
+    }
+    if (added > 0 || removed > 0 || moved) {  // buffered samples do not match the sensors anymore
+        RTCdata->batchCount = 0;
+        RTCdata->wakesSinceFlush = 0;
+    }
+    _recordTiming(TIMING_SEARCH, micros() - startedAt);
 }
 
 /*
-Helper to print Feature submenu during BrickSetup
+Helper to find the OneWire buses with parasite powered sensors
 */
-void NahsBricksFeatureTemp::_printMenu() {
-    Serial.println("1) Identify sensor");
-    Serial.println("2) Read sensors (raw)");
-    Serial.println("3) Read sensors (with corr)");
-    Serial.println("4) Set default precision");
-    Serial.println("5) Set sensor corr");
-    Serial.println("6) Delete sensor corr");
-    Serial.println("9) Return to MainMenu");
+void NahsBricksFeatureTemp::_checkPowerSupply() {
+    RTCdata->parasiteBuses = 0;
+    for (uint8_t b = 0; b < ONEWIRE_BUS_COUNT; ++b) {
+        if (_DS18B20[b].readPowerSupply()) RTCdata->parasiteBuses |= (1 << b);
+    }
 }
 
 /*
-BrickSetup function to identify a sensor by touching it
+Helper to fill the sensor addresses in RTCmem by a full search over all OneWire buses.
+Sensors are ordered by bus and by search order within a bus.
 */
-void NahsBricksFeatureTemp::_identifySensor() {
-    Serial.println("Reading initial Temperatures...");
-    _DS18B20.setWaitForConversion(true);
-    _DS18B20.requestTemperatures();
-    float iniTemps[RTCdata->sensorCount];
-    for(uint8_t i = 0; i < RTCdata->sensorCount; i++) iniTemps[i] = _getTempC(i);
-    float iniTempHDC = 0;
-    if (_HDC1080_connected) {
-        HDC1080.getT();  // dummy read to be able to trigger an new conversion
-        HDC1080.triggerRead();
-        iniTempHDC = HDC1080.getT();
-    }
-    float iniTempSHT = 0;
-    if (_SHT4x_connected) {
-        SHT4x.getT();  // dummy read to be able to trigger an new conversion
-        SHT4x.triggerRead();
-        iniTempSHT = SHT4x.getT();
+void NahsBricksFeatureTemp::_searchSensors() {
+    uint8_t count = 0;
+    for (uint8_t b = 0; b < ONEWIRE_BUS_COUNT; ++b) {
+        uint8_t busCount = 0;
+        _oneWire[b].reset_search();
+        while (count < MAX_TEMP_SENSORS_COUNT && _oneWire[b].search(_getSensorAddr(count))) {
+            if (!_DS18B20[b].validAddress(_getSensorAddr(count)) || !_DS18B20[b].validFamily(_getSensorAddr(count))) continue;
+            ++count;
+            ++busCount;
+        }
+        SAdata->busSensorCount[b] = busCount;
     }
+    RTCdata->sensorCount = count;
+    _assignSensorBuses();
+    _packSensorAddrs();
+}
 
-    Serial.println("Hit <enter> to start identification");
-    SerHelp.readLine();
-    Serial.println("--------------------");
-    bool finished = false;
-    for(uint8_t w = 0; w < 20; w++) {
-        _DS18B20.requestTemperatures();
-        if (_HDC1080_connected) {
-            HDC1080.triggerRead();
-            if((HDC1080.getT() - iniTempHDC) >= 2) {
-                Serial.println();
-                Serial.print("ID of Sensor is: ");
-                Serial.println(HDC1080.snToString(RTCdata->HDC1080SN));
-                finished = true;
-            }
-        }
-        if (_SHT4x_connected) {
-            SHT4x.triggerRead();
-            if((SHT4x.getT() - iniTempSHT) >= 2) {
-                Serial.println();
-                Serial.print("ID of Sensor is: ");
-                Serial.println(SHT4x.snToString(SHTdata->SHT4xSN));
-                finished = true;
-            }
-        }
-        for(uint8_t i = 0; i < RTCdata->sensorCount; i++) {
-            float t = _getTempC(i);
-            if((t - iniTemps[i]) >= 2) {
-                Serial.println();
-                Serial.print("ID of Sensor is: ");
-                Serial.println(_deviceAddrToString(i));
-                finished = true;
-                break;
-            }
+/*
+Helper to load the sensor addresses found on last full search from FSdata (one list per bus),
+returns false if any of them does not answer
+*/
+bool NahsBricksFeatureTemp::_loadInventory() {
+    JsonArray inventory = FSdata["sAddr"].as<JsonArray>();
+    if (inventory.size() != ONEWIRE_BUS_COUNT) return false;
+
+    uint8_t count = 0;
+    ScratchPad scratchPad;
+    uint64_t regsRead = 0;
+    for (uint8_t b = 0; b < ONEWIRE_BUS_COUNT; ++b) {
+        if (!inventory[b].is<JsonArray>()) return false;
+        uint8_t busCount = 0;
+        for (JsonVariant addr : inventory[b].as<JsonArray>()) {
+            if (count >= MAX_TEMP_SENSORS_COUNT) return false;
+            if (!_hexDecode(addr.as<const char*>(), _getSensorAddr(count), sizeof(DeviceAddress))) return false;
+            if (!_DS18B20[b].validFamily(_getSensorAddr(count))) return false;
+            if (!_DS18B20[b].isConnected(_getSensorAddr(count), scratchPad)) return false;  // reads the scratchpad and checks it's CRC
+            memcpy(_sensorRegs[count], scratchPad + OW_SCRATCHPAD_TH, sizeof(_sensorRegs[count]));  // kept for _transmitPrecisionToSensors
+            regsRead |= (uint64_t)1 << count;
+            ++count;
+            ++busCount;
         }
-        if(finished) break;
-        Serial.print('.');
-        delay(300);
-    }
-    if(!finished) {
-        Serial.println("\nNo Sensor could be identified...");
+        SAdata->busSensorCount[b] = busCount;
     }
+    if (count == 0) return false;
+    RTCdata->sensorCount = count;
+    _sensorRegsRead = regsRead;
+    _assignSensorBuses();
+    _packSensorAddrs();
+    return true;
 }
 
 /*
-BrickSetup function to do a temp-reading on all sensors (and put it out WITHOUT correction value)
+Helper to store the sensor addresses in RTCmem to FSdata (if they differ from the already stored ones)
 */
-void NahsBricksFeatureTemp::_readSensorsRaw() {
-    Serial.println("Requesting Temperatures...");
-    _DS18B20.setWaitForConversion(true);
-    _DS18B20.requestTemperatures();
-    if (_HDC1080_connected) {
-        HDC1080.getT();  // dummy read to be able to trigger an new conversion
-        HDC1080.triggerRead();
-        Serial.print(HDC1080.snToString(RTCdata->HDC1080SN));
-        Serial.print(": ");
-        Serial.println(HDC1080.getT());
-    }
-    if (_SHT4x_connected) {
-        SHT4x.getT();  // dummy read to be able to trigger an new conversion
-        SHT4x.triggerRead();
-        Serial.print(SHT4x.snToString(SHTdata->SHT4xSN));
-        Serial.print(": ");
-        Serial.println(SHT4x.getT());
+void NahsBricksFeatureTemp::_storeInventory() {
+    JsonArray inventory = FSdata["sAddr"].as<JsonArray>();
+    char id[2 * sizeof(DeviceAddress) + 1];
+    bool changed = (inventory.size() != ONEWIRE_BUS_COUNT);
+    uint8_t first = 0;
+    for (uint8_t b = 0; b < ONEWIRE_BUS_COUNT && !changed; ++b) {
+        JsonArray stored = inventory[b].as<JsonArray>();
+        changed = (stored.size() != SAdata->busSensorCount[b]);
+        for (uint8_t i = 0; i < SAdata->busSensorCount[b] && !changed; ++i) {
+            _hexEncode(_getSensorAddr(first + i), sizeof(DeviceAddress), id);
+            const char* storedID = stored[i].as<const char*>();
+            changed = (storedID == nullptr || strcmp(storedID, id) != 0);
+        }
+        first += SAdata->busSensorCount[b];
     }
-    for(uint8_t i = 0; i < RTCdata->sensorCount; ++i) {
-        Serial.print(_deviceAddrToString(i));
-        Serial.print(": ");
-        Serial.println(_getTempC(i));
+    if (!changed) return;
+
+    inventory.clear();
+    first = 0;
+    for (uint8_t b = 0; b < ONEWIRE_BUS_COUNT; ++b) {
+        JsonArray stored = inventory.createNestedArray();
+        for (uint8_t i = 0; i < SAdata->busSensorCount[b]; ++i) {
+            _hexEncode(_getSensorAddr(first + i), sizeof(DeviceAddress), id);
+            stored.add((char*)id);  // char* is copied by ArduinoJson
+        }
+        first += SAdata->busSensorCount[b];
     }
 }
 
 /*
-BrickSetup function to do a temp-reading on all sensors (and put it out WITH correction value)
+Returns true if the readings of this wake are delivered to BrickServer (always true if batching is disabled),
+the OS can use this to keep the radio off otherwise
 */
-void NahsBricksFeatureTemp::_readSensorsCorr() {
-    Serial.println("Requesting Temperatures...");
-    _DS18B20.setWaitForConversion(true);
-    _DS18B20.requestTemperatures();
-    if (_HDC1080_connected) {
-        HDC1080.getT();  // dummy read to be able to trigger an new conversion
-        HDC1080.triggerRead();
-        Serial.print(HDC1080.snToString(RTCdata->HDC1080SN));
-        Serial.print(": ");
-        Serial.println(HDC1080.getT() + RTCdata->HDC1080Corr);
-    }
-    if (_SHT4x_connected) {
-        SHT4x.getT();  // dummy read to be able to trigger an new conversion
-        SHT4x.triggerRead();
-        Serial.print(SHT4x.snToString(SHTdata->SHT4xSN));
-        Serial.print(": ");
-        Serial.println(SHT4x.getT() + SHTdata->SHT4xCorr);
-    }
-    for(uint8_t i = 0; i < RTCdata->sensorCount; ++i) {
-        Serial.print(_deviceAddrToString(i));
-        Serial.print(": ");
-        Serial.println((_getTempC(i) + SCdata->sensorCorr[i]));
-    }
+bool NahsBricksFeatureTemp::isBatchFlushDue() {
+    if (RTCdata->batchInterval <= 1 || BATCH_BUFFER_SLOTS == 0) return true;
+    if (RTCdata->wakesSinceFlush + 1 >= RTCdata->batchInterval) return true;
+    uint8_t channels = _activeChannelCount();
+    if (channels == 0) return true;
+    return (RTCdata->batchCount + 1) * channels > BATCH_BUFFER_SLOTS;  // no space left for another sample
 }
 
 /*
-BrickSetup function to set the default precision
+Returns the JsonDocument capacity the next deliver() needs at most (call after start()). This is an upper bound, not the exact usage:
+every reading is counted as delivered with the larger entry of a failed read, so the estimate is only reached if every read fails
+and is one slot per channel above the usage of a wake on which all reads succeed. Capacity is counted in slots of the
+JsonDocument (JSON_ARRAY_SIZE), so it follows the slot size of the platform ArduinoJson is built for
 */
-void NahsBricksFeatureTemp::_setDefaultPrecision() {
-    Serial.print("Enter precision (8 to 12): ");
-    uint8_t input = SerHelp.readLine().toInt();
-    if (input < 8 || input > 12) {
-        Serial.println("Invalid precision!");
-        return;
+size_t NahsBricksFeatureTemp::deliverCapacity() {
+    uint8_t channels = _activeChannelCount();
+    uint8_t errorChannels = 0;
+#if TEMP_TELEMETRY
+    for (uint8_t ch = 0; ch < CHANNEL_COUNT; ++ch) {
+        if (_isChannelActive(ch) && TMdata->readErrors[ch] > 0) ++errorChannels;
     }
-    FSdata["sPrec"] = input;
-    RTCdata->sensorPrecision = input;
-    Serial.println("Configuring sensors...");
-    _transmitPrecisionToSensors(false);
-    Serial.print("Set precision to: ");
-    Serial.println(input);
+#endif
+    return JSON_ARRAY_SIZE(_deliverSlots(RTCdata->sensorCount, channels, RTCdata->precisionRequested, RTCdata->sensorCorrRequested,
+                                         RTCdata->sensorsAdded > 0 || RTCdata->sensorsRemoved > 0, TEMP_TELEMETRY && RTCdata->timingRequested, errorChannels,
+                                         isBatchFlushDue(), RTCdata->batchCount, RTCdata->batchCount * channels, RTCdata->compactPayload, _isCompact()));
 }
 
 /*
-BrickSetup function to set a default correction value for a sensor
+Returns the number of bytes the next deliver() adds to the serialized json at most (call after start()). This is an upper bound:
+numbers are counted with their max width and every reading as delivered, so the actual json is shorter on most wakes
 */
-void NahsBricksFeatureTemp::_setDefaultCorr() {
-    Serial.print("Enter sensor ID: ");
-    String addr = SerHelp.readLine();
-    Serial.print("Enter correction value: ");
-    float corr = SerHelp.readLine().toFloat();
+size_t NahsBricksFeatureTemp::deliverSize() {
+    static const uint8_t MEMBER_CHARS = 4;  // quotes, colon and comma around a key
+    static const uint8_t ARRAY_CHARS = 2;  // brackets of an array, every element adds a comma
+    static const uint8_t NUMBER_CHARS = 10;  // max width of an uint32
+    uint8_t channels = _activeChannelCount();
+    size_t idChars = 0;  // quoted IDs of all active channels
+    size_t errorChars = 0;  // entries in tre
+    for (uint8_t ch = 0; ch < CHANNEL_COUNT; ++ch) {
+        if (!_isChannelActive(ch)) continue;
+        idChars += strlen(_getChannelID(ch)) + 2;
+#if TEMP_TELEMETRY
+        if (TMdata->readErrors[ch] > 0) errorChars += strlen(_getChannelID(ch)) + 2 + ARRAY_CHARS + 1 + 3;
+#endif
+    }
+    size_t size = 0;
+    if (!isBatchFlushDue()) return size;  // wakes that only buffer readings deliver nothing
 
-    if (HDC1080.snToString(RTCdata->HDC1080SN) == addr) {
-        RTCdata->HDC1080Corr = corr;
+    if (RTCdata->precisionRequested) {
+        size += MEMBER_CHARS + 1 + 2;  // p
+        size += MEMBER_CHARS + 3 + ARRAY_CHARS + RTCdata->sensorCount * (1 + ARRAY_CHARS + 2 + 2 * sizeof(DeviceAddress) + 2 + 2 + 2);  // tps with [id, precision, active precision]
     }
-    else if (SHT4x.snToString(SHTdata->SHT4xSN) == addr) {
-        SHTdata->SHT4xCorr = corr;
+    if (RTCdata->sensorCorrRequested) size += 2 * (MEMBER_CHARS + 2 + ARRAY_CHARS + idChars + channels * (ARRAY_CHARS + 2 + JSON_FLOAT_CHARS));  // c and tg
+    if (RTCdata->sensorsAdded > 0 || RTCdata->sensorsRemoved > 0) size += MEMBER_CHARS + 2 + ARRAY_CHARS + 3 + 1 + 3;  // tx
+    if (TEMP_TELEMETRY && RTCdata->timingRequested) {
+        size += MEMBER_CHARS + 2 + ARRAY_CHARS + TIMING_PHASE_COUNT * (ARRAY_CHARS + 3 + 3 * NUMBER_CHARS);  // tt
+        size += MEMBER_CHARS + 2 + ARRAY_CHARS + 2 + 3 * 5;  // te
+        size += MEMBER_CHARS + 3 + ARRAY_CHARS + channels + errorChars;  // tre
     }
-    else for (uint8_t i = 0; i < RTCdata->sensorCount; ++i) {
-        if (_deviceAddrToString(i) == addr) {
-            SCdata->sensorCorr[i] = corr;
-            break;
-        }
+
+    bool compact = _isCompact();
+    if (RTCdata->batchCount > 0) {
+        size += MEMBER_CHARS + 2 + ARRAY_CHARS + RTCdata->batchCount + 1;  // tb
+        size += compact ? NUMBER_CHARS : ARRAY_CHARS + channels + idChars;
+        size += RTCdata->batchCount * (ARRAY_CHARS + 3 + channels * 7);  // wakes and readings in 1/100 degree celsius (or null)
     }
-    FSdata["sCorr"].as<JsonObject>()[addr] = corr;
-    Serial.print("Set correction value of ");
-    Serial.print(addr);
-    Serial.print(" to ");
-    Serial.println(corr);
+    if (RTCdata->compactPayload) size += MEMBER_CHARS + 2 + NUMBER_CHARS;  // th
+    if (RTCdata->compactPayload && !compact) size += MEMBER_CHARS + 2 + ARRAY_CHARS + channels + idChars;  // ti
+    size += MEMBER_CHARS + 2 + ARRAY_CHARS + channels;  // t or tv
+    if (compact) size += channels * JSON_FLOAT_CHARS;  // value, null or [error]
+    else size += channels * (ARRAY_CHARS + 2 + JSON_FLOAT_CHARS) + idChars;  // [id, value] is longer than [id, null, error]
+    return size;
 }
 
 /*
-BrickSetup function to delete a default correction value for a sensor
+Helper to store the sensor addresses in RTCmem, the CRC of each address is left out as it can be derived
 */
-void NahsBricksFeatureTemp::_deleteDefaultCorr() {
-    Serial.print("Enter sensor ID: ");
-    String addr = SerHelp.readLine();
-
-    if (HDC1080.snToString(RTCdata->HDC1080SN) == addr) {
-        RTCdata->HDC1080Corr = 0;
+void NahsBricksFeatureTemp::_packSensorAddrs() {
+    for (uint8_t i = 0; i < MAX_TEMP_SENSORS_COUNT; ++i) {
+        if (i < RTCdata->sensorCount) memcpy(SAdata->sensorAddr[i], _sensorAddrs[i], SENSOR_PACKED_SIZE);
+        else memset(SAdata->sensorAddr[i], 0, SENSOR_PACKED_SIZE);
     }
-    else if (SHT4x.snToString(SHTdata->SHT4xSN) == addr) {
-        SHTdata->SHT4xCorr = 0;
+}
+
+/*
+Helper to restore the full sensor addresses from the packed ones stored in RTCmem
+*/
+void NahsBricksFeatureTemp::_unpackSensorAddrs() {
+    _assignSensorBuses();
+    for (uint8_t i = 0; i < RTCdata->sensorCount; ++i) {
+        memcpy(_sensorAddrs[i], SAdata->sensorAddr[i], SENSOR_PACKED_SIZE);
+        _sensorAddrs[i][7] = OneWire::crc8(_sensorAddrs[i], 7);
     }
-    else for (uint8_t i = 0; i < RTCdata->sensorCount; ++i) {
-        if (_deviceAddrToString(i) == addr) {
-            SCdata->sensorCorr[i] = 0;
-            break;
-        }
+}
+
+/*
+Helper to fill the bus of every sensor from the per bus sensor counts in RTCmem
+*/
+void NahsBricksFeatureTemp::_assignSensorBuses() {
+    uint8_t i = 0;
+    for (uint8_t b = 0; b < ONEWIRE_BUS_COUNT; ++b) {
+        for (uint8_t n = 0; n < SAdata->busSensorCount[b] && i < MAX_TEMP_SENSORS_COUNT; ++n) _sensorBus[i++] = b;
     }
+}
 
-    if (FSdata["sCorr"].as<JsonObject>().containsKey(addr)) FSdata["sCorr"].as<JsonObject>().remove(addr);
-    Serial.print("Deleted correction value of ");
-    Serial.println(addr);
+/*
+Helper to get the DallasTemperature instance of the bus a sensor (identified by index in RTCmem) is connected to
+*/
+DallasTemperature& NahsBricksFeatureTemp::_getSensorBus(uint8_t sensor_index) {
+    return _DS18B20[_sensorBus[sensor_index]];
 }
 
+/*
+Helper to get the address of a sensor (identified by index in RTCmem)
+*/
+uint8_t* NahsBricksFeatureTemp::_getSensorAddr(uint8_t sensor_index) {
+    return _sensorAddrs[sensor_index];
+}
+
+/*
+Helper to get the ID of a sensor (identified by index in RTCmem) as rendered by _renderSensorIDs
+*/
+const char* NahsBricksFeatureTemp::_getSensorID(uint8_t sensor_index) {
+    return _sensorIDs[sensor_index];
+}
+
+/*
+Helper to render the IDs of all connected sensors once per wake, so deliver() does not need to build any String
+*/
+void NahsBricksFeatureTemp::_renderSensorIDs() {
+    for (uint8_t i = 0; i < RTCdata->sensorCount; ++i) _hexEncode(_getSensorAddr(i), sizeof(DeviceAddress), _sensorIDs[i]);
+    _i2cSensors.renderIDs();
+}
+
+/*
+Helper to get the correction table from FSmem: a string of fixed-width records (CORR_RECORD_CHARS each) sorted by key.
+While the table is edited (see _editCorrTable) this is the working copy
+*/
+const char* NahsBricksFeatureTemp::_corrTable() {
+    if (_corrEdit != nullptr) return _corrEdit;
+    const char* table = CTdata["c"].as<const char*>();
+    return (table == nullptr) ? "" : table;
+}
+
+/*
+Helper to start editing the correction table: _storeCorr and _removeCorr work on a working copy with room for inserts
+more records, which is written to FSmem once by _saveCorrTable. Every replaced string stays in the FSmem document
+until it is saved to flash, so writing the table once per operation instead of once per record keeps the pool from filling up.
+Returns false if there is no memory for the working copy
+*/
+bool NahsBricksFeatureTemp::_editCorrTable(uint16_t inserts) {
+    const char* table = _corrTable();
+    size_t len = strlen(table);
+    char* edit = (char*)malloc(len + inserts * CORR_RECORD_CHARS + 1);
+    if (edit == nullptr) return false;
+    memcpy(edit, table, len + 1);
+    free(_corrEdit);
+    _corrEdit = edit;
+    _corrEditInserts = inserts;
+    return true;
+}
+
+/*
+Helper to write the working copy of the correction table to FSmem and end editing,
+returns false if the FSmem document has no room left for it (the stored table is unchanged then)
+*/
+bool NahsBricksFeatureTemp::_saveCorrTable() {
+    if (_corrEdit == nullptr) return false;
+    bool saved = CTdata["c"].set(_corrEdit);  // char* gets copied into the document
+    const char* table = CTdata["c"].as<const char*>();
+    saved = saved && table != nullptr && strcmp(table, _corrEdit) == 0;
+    free(_corrEdit);
+    _corrEdit = nullptr;
+    return saved;
+}
+
+/*
+Helper to render the key of a sensor ID in the correction table (lowercase, padded with '-' to CORR_KEY_CHARS)
+*/
+void NahsBricksFeatureTemp::_corrKey(const char* id, char* key) {
+    uint8_t i = 0;
+    for (; i < CORR_KEY_CHARS && id[i] != '\0'; ++i) key[i] = (id[i] >= 'A' && id[i] <= 'F') ? (id[i] | 0x20) : id[i];
+    for (; i < CORR_KEY_CHARS; ++i) key[i] = '-';
+    key[CORR_KEY_CHARS] = '\0';
+}
+
+/*
+Helper to binary search the correction table for a sensor ID,
+returns the index of it's record or -(index where it would be inserted + 1) if there is none
+*/
+int16_t NahsBricksFeatureTemp::_findCorrRecord(const char* id) {
+    char key[CORR_KEY_CHARS + 1];
+    _corrKey(id, key);
+    const char* table = _corrTable();
+    int16_t low = 0;
+    int16_t high = strlen(table) / CORR_RECORD_CHARS - 1;
+    while (low <= high) {
+        int16_t mid = (low + high) / 2;
+        int cmp = strncmp(table + mid * CORR_RECORD_CHARS, key, CORR_KEY_CHARS);
+        if (cmp == 0) return mid;
+        if (cmp < 0) low = mid + 1;
+        else high = mid - 1;
+    }
+    return -(low + 1);
+}
+
+/*
+Helper to get the correction (in 1/128 degree celsius) of a record in the correction table
+*/
+int16_t NahsBricksFeatureTemp::_getCorrRecord(int16_t index) {
+    return _decodeRecordField(index, CORR_KEY_CHARS);
+}
+
+/*
+Helper to get the gain deviation (in 1/32768) of a record in the correction table
+*/
+int16_t NahsBricksFeatureTemp::_getGainRecord(int16_t index) {
+    return _decodeRecordField(index, CORR_KEY_CHARS + 4);
+}
+
+/*
+Helper to decode the int16 field (4 hex chars) at pos of a record in the correction table
+*/
+int16_t NahsBricksFeatureTemp::_decodeRecordField(int16_t index, uint8_t pos) {
+    char hex[5];
+    uint8_t data[2] = {0, 0};
+    strncpy(hex, _corrTable() + index * CORR_RECORD_CHARS + pos, 4);
+    hex[4] = '\0';
+    _hexDecode(hex, data, 2);
+    return (int16_t)((data[0] << 8) | data[1]);
+}
+
+/*
+Helper to insert or replace the correction (in 1/128 degree celsius) and gain deviation (in 1/32768) of a sensor ID
+in the working copy of the correction table, returns false if the table is not edited or has no room for another record
+*/
+bool NahsBricksFeatureTemp::_storeCorr(const char* id, int16_t corr, int16_t gain) {
+    if (_corrEdit == nullptr) return false;
+    int16_t index = _findCorrRecord(id);
+    bool replace = (index >= 0);
+    if (!replace) {
+        if (_corrEditInserts == 0) return false;
+        index = -index - 1;
+    }
+
+    char record[CORR_RECORD_CHARS + 1];
+    uint8_t data[4] = {(uint8_t)((uint16_t)corr >> 8), (uint8_t)corr, (uint8_t)((uint16_t)gain >> 8), (uint8_t)gain};
+    _corrKey(id, record);
+    _hexEncode(data, 4, record + CORR_KEY_CHARS);
+
+    char* pos = _corrEdit + index * CORR_RECORD_CHARS;
+    if (!replace) {
+        memmove(pos + CORR_RECORD_CHARS, pos, strlen(pos) + 1);
+        --_corrEditInserts;
+    }
+    memcpy(pos, record, CORR_RECORD_CHARS);
+    return true;
+}
+
+/*
+Helper to remove the correction of a sensor ID from the working copy of the correction table
+*/
+void NahsBricksFeatureTemp::_removeCorr(const char* id) {
+    if (_corrEdit == nullptr) return;
+    int16_t index = _findCorrRecord(id);
+    if (index < 0) return;
+
+    char* pos = _corrEdit + index * CORR_RECORD_CHARS;
+    memmove(pos, pos + CORR_RECORD_CHARS, strlen(pos + CORR_RECORD_CHARS) + 1);
+    ++_corrEditInserts;
+}
+
+/*
+Helper to move the corrections of the former sCorr dict (sensorAddr as key, degree celsius as value) into the correction table,
+sCorr is only removed once the table is saved (else the migration is repeated on the next wake)
+*/
+void NahsBricksFeatureTemp::_migrateCorrMap() {
+    JsonObject sCorr = FSdata["sCorr"].as<JsonObject>();
+    if (!_editCorrTable(sCorr.size())) return;
+    for (JsonPair kv : sCorr) {
+        int16_t corr;
+        if (_cToCorr(kv.value().as<float>(), &corr)) _storeCorr(kv.key().c_str(), corr, 0);  // corrections out of range are dropped
+    }
+    if (_saveCorrTable()) FSdata.remove("sCorr");
+}
+
+/*
+Helper to render len bytes of data as lowercase hex-string into out (which needs to hold 2 * len + 1 chars)
+*/
+void NahsBricksFeatureTemp::_hexEncode(const uint8_t* data, uint8_t len, char* out) {
+    tempHexEncode(data, len, out);
+}
+
+/*
+Helper to parse a hex-string (as rendered by _hexEncode) back into len bytes of data, returns false if str is malformed
+*/
+bool NahsBricksFeatureTemp::_hexDecode(const char* str, uint8_t* data, uint8_t len) {
+    if (str == nullptr || strlen(str) != 2 * len) return false;
+    for (uint8_t i = 0; i < 2 * len; ++i) {
+        char c = str[i] | 0x20;  // lowercase
+        uint8_t nibble;
+        if (c >= '0' && c <= '9') nibble = c - '0';
+        else if (c >= 'a' && c <= 'f') nibble = c - 'a' + 10;
+        else return false;
+        if (i % 2 == 0) data[i / 2] = nibble << 4;
+        else data[i / 2] |= nibble;
+    }
+    return true;
+}
+
+/*
+Helper to read the raw temperature (in 1/128 degree celsius) of a sensor (identified by index in RTCmem), returns READ_OK or the error.
+With a single sensor the scratchpad is read with Skip-ROM, the ROM is only addressed if that read fails.
+*/
+uint8_t NahsBricksFeatureTemp::_readTempRaw(uint8_t sensor_index, int32_t* raw) {
+    if (RTCdata->sensorCount == 1 && _readScratchpad(sensor_index, true, raw) == READ_OK) return READ_OK;
+    return _readScratchpad(sensor_index, false, raw);
+}
+
+/*
+Helper to read the raw temperature (in 1/128 degree celsius) from the scratchpad of a sensor, returns READ_OK or the error.
+With skipRom the sensor is not addressed (saves sending it's 64 bit address), which only works for the only sensor on a bus.
+A DS18S20 holds 0.5 degree celsius readings, it's full resolution is calculated from COUNT_REMAIN like DallasTemperature does.
+*/
+uint8_t NahsBricksFeatureTemp::_readScratchpad(uint8_t sensor_index, bool skipRom, int32_t* raw) {
+    OneWire& oneWire = _oneWire[_sensorBus[sensor_index]];
+    ScratchPad scratchPad;
+    if (!oneWire.reset()) return READ_ERROR_BUS;
+    if (skipRom) oneWire.skip();
+    else oneWire.select(_getSensorAddr(sensor_index));
+    oneWire.write(OW_READ_SCRATCHPAD);
+    oneWire.read_bytes(scratchPad, sizeof(ScratchPad));
+    if (OneWire::crc8(scratchPad, sizeof(ScratchPad) - 1) != scratchPad[sizeof(ScratchPad) - 1]) return READ_ERROR_CRC;
+    if ((scratchPad[OW_SCRATCHPAD_CONFIG] & 0x1F) != 0x1F) return READ_ERROR_CRC;  // reserved bits are always set, rules out an all-zero scratchpad
+    int16_t reading = (int16_t)((scratchPad[OW_SCRATCHPAD_TEMP_LSB + 1] << 8) | scratchPad[OW_SCRATCHPAD_TEMP_LSB]);
+    if (_hasConfigRegister(sensor_index)) *raw = reading * 8;  // 1/16 to 1/128 degree celsius
+    else {
+        uint8_t countPerC = scratchPad[OW_SCRATCHPAD_COUNT_PER_C];
+        if (countPerC == 0) return READ_ERROR_CRC;
+        *raw = (reading & ~1) * 64 - 32 + ((countPerC - scratchPad[OW_SCRATCHPAD_COUNT_REMAIN]) << 7) / countPerC;  // whole degrees - 0.25 + fraction
+    }
+    if (*raw == POWER_ON_RAW) return READ_ERROR_POWER_ON;
+    return READ_OK;
+}
+
+/*
+Helper to check if a reading holds a temperature (and not NO_READING or a failed read)
+*/
+bool NahsBricksFeatureTemp::_isReading(int32_t value) {
+    return value > READ_ERROR_MARK;
+}
+
+/*
+Helper to convert a raw temperature (in 1/128 degree celsius) to degree celsius
+*/
+float NahsBricksFeatureTemp::_rawToC(int32_t raw) {
+    return raw / 128.0f;
+}
+
+/*
+Helper to convert degree celsius to a raw temperature (in 1/128 degree celsius)
+*/
+int32_t NahsBricksFeatureTemp::_cToRaw(float celsius) {
+    return lroundf(celsius * 128);
+}
+
+/*
+Helper to convert a raw temperature (in 1/128 degree celsius) to 1/100 degree celsius (rounded)
+*/
+int32_t NahsBricksFeatureTemp::_rawToCenti(int32_t raw) {
+    int32_t scaled = raw * 100;
+    if (scaled >= 0) return (scaled + 64) / 128;
+    return (scaled - 64) / 128;
+}
+
+/*
+Helper to apply gain and correction to a raw temperature (all in 1/128 degree celsius), costs a single multiplication
+*/
+int32_t NahsBricksFeatureTemp::_calibrate(int32_t raw, int16_t corr, int16_t gain) {
+    return raw + ((raw * gain) >> GAIN_SHIFT) + corr;
+}
+
+/*
+Helper to convert a gain deviation (in 1/32768) to a gain factor
+*/
+float NahsBricksFeatureTemp::_gainToFactor(int16_t gain) {
+    return 1.0f + (float)gain / (1 << GAIN_SHIFT);
+}
+
+/*
+Helper to convert a gain factor to a gain deviation (in 1/32768), returns false if factor is not between 0 and 2
+*/
+bool NahsBricksFeatureTemp::_factorToGain(float factor, int16_t* gain) {
+    int32_t deviation = lroundf((factor - 1.0f) * (1 << GAIN_SHIFT));
+    if (deviation < INT16_MIN || deviation > INT16_MAX) return false;
+    *gain = deviation;
+    return true;
+}
+
+/*
+Helper to convert a correction in degree celsius to 1/128 degree celsius, returns false if it is not within +-CORR_MAX_C
+*/
+bool NahsBricksFeatureTemp::_cToCorr(float celsius, int16_t* corr) {
+    if (!(fabsf(celsius) <= CORR_MAX_C)) return false;  // also rejects NAN
+    *corr = _cToRaw(celsius);
+    return true;
+}
+
+/*
+Helper to set correction (in 1/128 degree celsius) and gain deviation (in 1/32768) of a sensor,
+stored in the correction table (which needs to be edited, see _editCorrTable) and applied right away if the sensor is connected
+*/
+void NahsBricksFeatureTemp::_setCalibration(const char* id, int16_t corr, int16_t gain) {
+    int8_t channel = _findChannel(id);
+    if (channel >= 0) {
+        _setChannelCorr(channel, corr);
+        _setChannelGain(channel, gain);
+    }
+    _storeCorr(id, corr, gain);
+}
+
+/*
+Helper to read all connected sensors (with correction, in 1/128 degree celsius) into values (indexed by channel).
+Sensor groups (all DS18B20 sensors, every single-chip sensor) are read in order of their conversion deadline,
+sleeping until the next deadline instead of polling the bus
+*/
+void NahsBricksFeatureTemp::_readChannels(int32_t* values) {
+    static const uint8_t GROUP_COUNT = 1 + I2CSensors::COUNT;  // group 0 are the DS18B20 sensors, group k + 1 the single-chip sensor k
+    static_assert(GROUP_COUNT <= 32, "too many single-chip sensors");
+    uint32_t pending = (RTCdata->sensorCount > 0) ? 1 : 0;
+    for (uint8_t k = 0; k < I2CSensors::COUNT; ++k) {
+        if (_i2cSensors.isConnected(k)) pending |= (uint32_t)1 << (k + 1);
+    }
+
+    while (pending) {
+        uint8_t next = 0;
+        uint32_t nextWait = UINT32_MAX;
+        for (uint8_t g = 0; g < GROUP_COUNT; ++g) {
+            if (!(pending & ((uint32_t)1 << g))) continue;
+            uint32_t wait = _msUntil((g == 0) ? _DS18B20ReadyAt : _i2cSensors.getReadyAt(g - 1));
+            if (wait < nextWait) {
+                next = g;
+                nextWait = wait;
+            }
+        }
+        if (nextWait > 0) delay(nextWait);
+        if (next == 0) _readDS18B20(values);
+        else {
+            float t = _i2cSensors.getT(next - 1);
+            if (isnan(t)) {
+                values[I2C_CHANNEL + next - 1] = NO_READING + READ_ERROR_NO_DATA;
+                _countReadError(I2C_CHANNEL + next - 1, READ_ERROR_NO_DATA);
+            }
+            else values[I2C_CHANNEL + next - 1] = _calibrate(_cToRaw(t), _i2cSensors.getCorr(next - 1), _i2cSensors.getGain(next - 1));
+        }
+        pending &= ~((uint32_t)1 << next);
+    }
+}
+
+/*
+Helper to read all DS18B20 sensors (with correction, in 1/128 degree celsius) into values (indexed by sensor).
+Only a failing sensor is retried (reconverted if it shows the power-on value) as long as the retry finishes within READ_RETRY_DEADLINE_MS after begin(),
+sensors that still fail get NO_READING + error.
+*/
+void NahsBricksFeatureTemp::_readDS18B20(int32_t* values) {
+    _waitForConversion();
+
+    uint64_t alarmed = RTCdata->alarmMode ? _searchAlarms() : UINT64_MAX;
+    for (uint8_t i = 0; i < RTCdata->sensorCount; ++i) {
+        if (!(alarmed & ((uint64_t)1 << i))) {
+            values[i] = NO_READING;
+            continue;
+        }
+        int32_t raw;
+        uint8_t error = _readTempRaw(i, &raw);
+        bool discovered = _sensorsDiscovered || (_newSensors & ((uint64_t)1 << i));
+        for (uint8_t retry = 0; error != READ_OK; ++retry) {
+            if (!(discovered && error == READ_ERROR_POWER_ON)) _countReadError(i, error);  // first conversion after discovery may still show the power-on value
+            uint32_t duration = (error == READ_ERROR_POWER_ON) ? _getSensorBus(i).millisToWaitForConversion(_getActivePrecision(i)) : 1;
+            if (retry >= READ_RETRIES || _msUntil(_begunAt + READ_RETRY_DEADLINE_MS) < duration) break;
+            if (error == READ_ERROR_POWER_ON) {
+                _convert(_sensorBus[i], _getSensorAddr(i));
+                delay(duration);
+            }
+            error = _readTempRaw(i, &raw);
+        }
+        if (error == READ_OK) values[i] = _calibrate(raw, SCdata->sensorCorr[i], SCdata->sensorGain[i]);
+        else values[i] = NO_READING + error;
+    }
+}
+
+/*
+Helper to do an alarm search on all OneWire buses (after a conversion), returns a bitmask of the sensor indexes
+that are outside of their alarm thresholds
+*/
+uint64_t NahsBricksFeatureTemp::_searchAlarms() {
+    uint64_t alarmed = 0;
+    DeviceAddress addr;
+    uint8_t first = 0;  // index of first sensor on current bus
+    for (uint8_t b = 0; b < ONEWIRE_BUS_COUNT; ++b) {
+        if (SAdata->busSensorCount[b] == 0) continue;
+        _DS18B20[b].resetAlarmSearch();
+        while (_DS18B20[b].alarmSearch(addr)) {
+            for (uint8_t i = first; i < first + SAdata->busSensorCount[b]; ++i) {
+                if (memcmp(addr, _getSensorAddr(i), sizeof(DeviceAddress)) == 0) alarmed |= (uint64_t)1 << i;
+            }
+        }
+        first += SAdata->busSensorCount[b];
+    }
+    return alarmed;
+}
+
+/*
+Helper to write the alarm thresholds (in degree celsius) of a DS18B20 sensor to it's EEPROM, returns false if there is no sensor with this ID.
+Both thresholds go with the configured precision in a single scratchpad write and EEPROM copy (a lowered adaptive precision is not stored).
+*/
+bool NahsBricksFeatureTemp::_setAlarmThresholds(const char* id, int8_t low, int8_t high) {
+    int8_t channel = _findChannel(id);
+    if (channel < 0 || channel >= I2C_CHANNEL || low > high) return false;
+    _writeScratchpad(channel, (uint8_t)high, (uint8_t)low, _precisionToConfig(_getPrecision(channel)), true);
+    PRdata->precision[channel] = (_getPrecision(channel) << 4) | _getPrecision(channel);
+    return true;
+}
+
+/*
+Helper to check if a channel (DS18B20 sensor index or I2C_CHANNEL + index of single-chip sensor) is connected
+*/
+bool NahsBricksFeatureTemp::_isChannelActive(uint8_t channel) {
+    if (channel >= I2C_CHANNEL) return _i2cSensors.isConnected(channel - I2C_CHANNEL);
+    return channel < RTCdata->sensorCount;
+}
+
+/*
+Helper to get the ID of a channel (DS18B20 sensor index or I2C_CHANNEL + index of single-chip sensor)
+*/
+const char* NahsBricksFeatureTemp::_getChannelID(uint8_t channel) {
+    if (channel >= I2C_CHANNEL) return _i2cSensors.getID(channel - I2C_CHANNEL);
+    return _getSensorID(channel);
+}
+
+/*
+Helper to get the correction value (in 1/128 degree celsius) of a channel
+*/
+int16_t NahsBricksFeatureTemp::_getChannelCorr(uint8_t channel) {
+    if (channel >= I2C_CHANNEL) return _i2cSensors.getCorr(channel - I2C_CHANNEL);
+    return SCdata->sensorCorr[channel];
+}
+
+/*
+Helper to set the correction value (in 1/128 degree celsius) of a channel
+*/
+void NahsBricksFeatureTemp::_setChannelCorr(uint8_t channel, int16_t corr) {
+    if (channel >= I2C_CHANNEL) _i2cSensors.setCorr(channel - I2C_CHANNEL, corr);
+    else SCdata->sensorCorr[channel] = corr;
+}
+
+/*
+Helper to get the gain deviation (in 1/32768) of a channel
+*/
+int16_t NahsBricksFeatureTemp::_getChannelGain(uint8_t channel) {
+    if (channel >= I2C_CHANNEL) return _i2cSensors.getGain(channel - I2C_CHANNEL);
+    return SCdata->sensorGain[channel];
+}
+
+/*
+Helper to set the gain deviation (in 1/32768) of a channel
+*/
+void NahsBricksFeatureTemp::_setChannelGain(uint8_t channel, int16_t gain) {
+    if (channel >= I2C_CHANNEL) _i2cSensors.setGain(channel - I2C_CHANNEL, gain);
+    else SCdata->sensorGain[channel] = gain;
+}
+
+/*
+Helper to find the connected channel with the given ID, returns -1 if there is none
+*/
+int8_t NahsBricksFeatureTemp::_findChannel(const char* id) {
+    for (uint8_t ch = 0; ch < CHANNEL_COUNT; ++ch) {
+        if (_isChannelActive(ch) && strcmp(_getChannelID(ch), id) == 0) return ch;
+    }
+    return -1;
+}
+
+/*
+Helper to count the connected channels
+*/
+uint8_t NahsBricksFeatureTemp::_activeChannelCount() {
+    uint8_t count = RTCdata->sensorCount;
+    for (uint8_t k = 0; k < I2CSensors::COUNT; ++k) {
+        if (_i2cSensors.isConnected(k)) ++count;
+    }
+    return count;
+}
+
+/*
+Helper to calculate the hash (FNV-1a) over the IDs of all connected channels in channel order, never returns 0
+*/
+uint32_t NahsBricksFeatureTemp::_calcTableHash() {
+    uint32_t hash = 2166136261UL;
+    for (uint8_t ch = 0; ch < CHANNEL_COUNT; ++ch) {
+        if (!_isChannelActive(ch)) continue;
+        for (const char* c = _getChannelID(ch); ; ++c) {
+            hash = (hash ^ (uint8_t)*c) * 16777619UL;
+            if (*c == '\0') break;  // terminator separates the IDs
+        }
+    }
+    return (hash == 0) ? 1 : hash;
+}
+
+/*
+Helper to check if readings are delivered as compact payload (opted in and the current channel table is acknowledged by BrickServer)
+*/
+bool NahsBricksFeatureTemp::_isCompact() {
+    return RTCdata->compactPayload && RTCdata->ackedTableHash == _tableHash;
+}
+
+/*
+Helper to calculate every how many wakes a sample is buffered in batching mode
+*/
+uint8_t NahsBricksFeatureTemp::_batchStep() {
+    if (RTCdata->batchSize == 0 || RTCdata->batchSize >= RTCdata->batchInterval) return 1;
+    return RTCdata->batchInterval / RTCdata->batchSize;
+}
+
+#if TEMP_BATCH_BUFFER_SLOTS > 0
+/*
+Helper to append the readings of this wake (if it is a sampling wake) to the batch buffer in RTCmem,
+samples are laid out by the channel table of the first one (the buffer is dropped in begin() once the table changes)
+*/
+void NahsBricksFeatureTemp::_bufferReadings(int32_t* values) {
+    if (RTCdata->wakesSinceFlush % _batchStep() == 0) {
+        if (RTCdata->batchCount == 0) BTdata->tableHash = _tableHash;
+        int16_t* sample = BTdata->values + RTCdata->batchCount * _activeChannelCount();
+        for (uint8_t ch = 0; ch < CHANNEL_COUNT; ++ch) {
+            if (_isChannelActive(ch)) *sample++ = _isReading(values[ch]) ? _rawToCenti(values[ch]) : NOTHING_SENT;
+        }
+        ++RTCdata->batchCount;
+    }
+    ++RTCdata->wakesSinceFlush;
+}
+
+/*
+Helper to add the batch buffer to outgoing json as array tb. The first entry holds the IDs of all channels,
+every further entry is one sample: number of wakes before this one followed by the readings in 1/100 degree celsius
+*/
+void NahsBricksFeatureTemp::_flushBatch(JsonDocument* out_json) {
+    JsonArray b_array;
+    if (out_json->containsKey("tb"))
+        b_array = out_json->operator[]("tb").as<JsonArray>();
+    else
+        b_array = out_json->createNestedArray("tb");
+
+    // the channel table is referenced by it's hash if BrickServer acknowledged it
+    if (_isCompact()) b_array.add(_tableHash);
+    else {
+        JsonArray id_array = b_array.createNestedArray();
+        for (uint8_t ch = 0; ch < CHANNEL_COUNT; ++ch) {
+            if (_isChannelActive(ch)) id_array.add(_getChannelID(ch));
+        }
+    }
+
+    uint8_t channels = _activeChannelCount();
+    uint8_t step = _batchStep();
+    for (uint8_t s = 0; s < RTCdata->batchCount; ++s) {
+        JsonArray s_array = b_array.createNestedArray();
+        s_array.add(RTCdata->wakesSinceFlush - s * step);
+        for (uint8_t i = 0; i < channels; ++i) {
+            if (BTdata->values[s * channels + i] == NOTHING_SENT) s_array.add();  // null
+            else s_array.add(BTdata->values[s * channels + i]);
+        }
+    }
+}
+#endif
+
+/*
+Helper to add the reading of a sensor to t_array, if it left the deadband around the last delivered value (or force is true).
+Without id (compact payload) only the value is added and skipped readings are added as null to keep the channel order.
+Failed reads are always added, as [id, null, error] or as [error] in compact payload.
+*/
+void NahsBricksFeatureTemp::_addReading(JsonArray t_array, const char* id, int32_t value, uint8_t channel, bool force) {
+    if (value != NO_READING && !_isReading(value)) {
+        JsonArray e_array = t_array.createNestedArray();
+        if (id != nullptr) {
+            e_array.add(id);
+            e_array.add();  // null
+        }
+        e_array.add((uint8_t)(value - NO_READING));
+        return;
+    }
+    bool skip = (value == NO_READING);
+    int16_t centi = skip ? NOTHING_SENT : _rawToCenti(value);
+    if (!skip && !force && DBdata->lastSent[channel] != NOTHING_SENT && abs(centi - DBdata->lastSent[channel]) <= RTCdata->deadband) skip = true;
+    if (!skip) DBdata->lastSent[channel] = centi;
+    if (id == nullptr) {
+        if (skip) t_array.add();  // null
+        else if (RTCdata->centiFormat) t_array.add(centi);
+        else t_array.add(_rawToC(value));
+        return;
+    }
+    if (skip) return;
+
+    JsonArray s_array = t_array.createNestedArray();
+    s_array.add(id);
+    if (RTCdata->centiFormat) s_array.add(centi);
+    else s_array.add(_rawToC(value));
+}
+
+/*
+Helper to get the configured precision of a sensor (identified by index in RTCmem)
+*/
+uint8_t NahsBricksFeatureTemp::_getPrecision(uint8_t sensor_index) {
+    return PRdata->precision[sensor_index] & 0x0F;
+}
+
+/*
+Helper to get the precision a sensor (identified by index in RTCmem) is currently running with (differs from
+the configured one if adaptive precision lowered it)
+*/
+uint8_t NahsBricksFeatureTemp::_getActivePrecision(uint8_t sensor_index) {
+    return PRdata->precision[sensor_index] >> 4;
+}
+
+/*
+Helper to set the configured and active precision of all sensors from FSdata, sensors without
+own precision get the default one
+*/
+void NahsBricksFeatureTemp::_loadSensorPrecisions() {
+    for (uint8_t i = 0; i < RTCdata->sensorCount; ++i) _loadSensorPrecision(i);
+}
+
+/*
+Helper to set the configured and active precision of a sensor (identified by index in RTCmem) from FSdata
+*/
+void NahsBricksFeatureTemp::_loadSensorPrecision(uint8_t sensor_index) {
+    JsonObject sPrecS = FSdata["sPrecS"].as<JsonObject>();
+    uint8_t p = RTCdata->sensorPrecision;
+    if (sPrecS.containsKey(_getSensorID(sensor_index))) p = sPrecS[_getSensorID(sensor_index)].as<uint8_t>();
+    p = constrain(p, 9, 12);
+    if (!_hasConfigRegister(sensor_index)) p = 12;  // a DS18S20 always converts as long as a DS18B20 with 12 bit
+    PRdata->precision[sensor_index] = (p << 4) | p;
+#if TEMP_ADAPTIVE_PRECISION
+    PRdata->lastReading[sensor_index] = NOTHING_SENT;
+#endif
+}
+
+/*
+Helper to set correction and gain of a channel from the correction table (both 0 if the channel is not connected or has no record)
+*/
+void NahsBricksFeatureTemp::_loadChannelCalibration(uint8_t channel) {
+    int16_t record = _isChannelActive(channel) ? _findCorrRecord(_getChannelID(channel)) : -1;
+    _setChannelCorr(channel, (record >= 0) ? _getCorrRecord(record) : 0);
+    _setChannelGain(channel, (record >= 0) ? _getGainRecord(record) : 0);
+}
+
+#if TEMP_FILTERING
+/*
+Helper to drop the filter state of all channels
+*/
+void NahsBricksFeatureTemp::_resetFilters() {
+    for (uint8_t ch = 0; ch < CHANNEL_COUNT; ++ch) FLdata->samples[ch] = 0;
+}
+
+/*
+Helper to replace the readings (in 1/128 degree celsius) of all connected channels by their filtered value,
+runs every wake (also if readings are only buffered) so the filter state follows every reading
+*/
+void NahsBricksFeatureTemp::_filterReadings(int32_t* values) {
+    for (uint8_t ch = 0; ch < CHANNEL_COUNT; ++ch) {
+        if (!_isChannelActive(ch) || !_isReading(values[ch])) continue;
+        if (RTCdata->filterMode == FILTER_MEDIAN) values[ch] = _filterMedian(ch, values[ch]);
+        else values[ch] = _filterEMA(ch, values[ch]);
+    }
+}
+
+/*
+Helper to get the median of the current and the previous filterParam - 1 readings of a channel (mean of the middle two if their number is even)
+*/
+int32_t NahsBricksFeatureTemp::_filterMedian(uint8_t channel, int32_t value) {
+    int16_t* history = FLdata->channel[channel].history;
+    uint8_t& samples = FLdata->samples[channel];
+
+    int32_t sorted[FILTER_MEDIAN_MAX];
+    uint8_t count = 0;
+    sorted[count++] = value;
+    for (uint8_t h = 0; h < samples; ++h) {
+        int32_t v = history[h];
+        uint8_t pos = count++;
+        while (pos > 0 && sorted[pos - 1] > v) {
+            sorted[pos] = sorted[pos - 1];
+            --pos;
+        }
+        sorted[pos] = v;
+    }
+
+    if (samples < RTCdata->filterParam - 1) ++samples;
+    for (uint8_t h = samples - 1; h > 0; --h) history[h] = history[h - 1];
+    history[0] = value;
+
+    if (count % 2) return sorted[count / 2];
+    return (sorted[count / 2 - 1] + sorted[count / 2]) / 2;
+}
+
+/*
+Helper to get the exponential moving average of a channel, the current reading is weighted with 1/2^filterParam
+*/
+int32_t NahsBricksFeatureTemp::_filterEMA(uint8_t channel, int32_t value) {
+    int32_t& ema = FLdata->channel[channel].ema;
+    if (FLdata->samples[channel] == 0) {
+        ema = value * (1 << EMA_FRACTION_BITS);
+        FLdata->samples[channel] = 1;
+    }
+    else ema += (value * (1 << EMA_FRACTION_BITS) - ema) >> RTCdata->filterParam;
+    return (ema + (1 << (EMA_FRACTION_BITS - 1))) >> EMA_FRACTION_BITS;
+}
+#endif
+
+#if TEMP_ADAPTIVE_PRECISION
+/*
+Helper to adapt the active precision of every sensor to it's rate of change: stable sensors run with
+9 or 10 bit (which is much faster to convert), changing ones with their configured precision
+*/
+void NahsBricksFeatureTemp::_adaptPrecision(int32_t* values) {
+    for (uint8_t i = 0; i < RTCdata->sensorCount; ++i) {
+        if (!_isReading(values[i])) continue;
+        uint8_t p = _getPrecision(i);
+        if (PRdata->lastReading[i] != NOTHING_SENT) {
+            int32_t delta = abs(values[i] - PRdata->lastReading[i]);
+            if (delta < ADAPTIVE_STEADY_DELTA) p = min(p, (uint8_t)9);
+            else if (delta < ADAPTIVE_MOVING_DELTA) p = min(p, (uint8_t)10);
+        }
+        PRdata->lastReading[i] = values[i];
+        if (p == _getActivePrecision(i)) continue;
+        if (_writeVolatilePrecision(i, p)) PRdata->precision[i] = (p << 4) | _getPrecision(i);
+    }
+}
+
+/*
+Helper to write every sensor that runs with an adaptive (lowered) precision back to it's configured precision
+*/
+void NahsBricksFeatureTemp::_restorePrecisions() {
+    for (uint8_t i = 0; i < RTCdata->sensorCount; ++i) {
+        if (_getActivePrecision(i) == _getPrecision(i)) continue;
+        if (_writeVolatilePrecision(i, _getPrecision(i))) PRdata->precision[i] = (_getPrecision(i) << 4) | _getPrecision(i);
+    }
+}
+#endif
+
+/*
+Helper to change the precision of a sensor in it's scratchpad only (without copying it to the sensors EEPROM),
+as adaptive precision changes it frequently. Returns false if the sensor did not answer or has no precision to change (DS18S20).
+*/
+bool NahsBricksFeatureTemp::_writeVolatilePrecision(uint8_t sensor_index, uint8_t precision) {
+    if (!_hasConfigRegister(sensor_index)) return false;
+    ScratchPad scratchPad;
+    if (!_getSensorBus(sensor_index).isConnected(_getSensorAddr(sensor_index), scratchPad)) {
+        _countReadError(sensor_index);
+        return false;
+    }
+    _writeScratchpad(sensor_index, scratchPad[OW_SCRATCHPAD_TH], scratchPad[OW_SCRATCHPAD_TL], _precisionToConfig(precision), false);
+    return true;
+}
+
+/*
+Helper to write TH, TL and configuration register (a DS18S20 has none) to the scratchpad of a sensor, with copy they are
+copied to it's EEPROM (parasite powered sensors get the strong pull-up during the copy)
+*/
+void NahsBricksFeatureTemp::_writeScratchpad(uint8_t sensor_index, uint8_t th, uint8_t tl, uint8_t config, bool copy) {
+    OneWire& oneWire = _oneWire[_sensorBus[sensor_index]];
+    oneWire.reset();
+    oneWire.select(_getSensorAddr(sensor_index));
+    oneWire.write(OW_WRITE_SCRATCHPAD);
+    oneWire.write(th);
+    oneWire.write(tl);
+    if (_hasConfigRegister(sensor_index)) oneWire.write(config);
+    if (_sensorRegsRead & ((uint64_t)1 << sensor_index)) {  // keep registers read during this wake up to date
+        _sensorRegs[sensor_index][0] = th;
+        _sensorRegs[sensor_index][1] = tl;
+        _sensorRegs[sensor_index][2] = config;
+    }
+    if (!copy) return;
+    bool parasite = RTCdata->parasiteBuses & (1 << _sensorBus[sensor_index]);
+    oneWire.reset();
+    oneWire.select(_getSensorAddr(sensor_index));
+    oneWire.write(OW_COPY_SCRATCHPAD, parasite);
+    delay(OW_COPY_MS);
+    if (parasite) oneWire.depower();
+}
+
+/*
+Helper to issue Convert-T on a OneWire bus, to a single sensor (addr) or to all sensors of the bus (addr is nullptr).
+Parasite powered sensors get the strong pull-up until the next command on the bus.
+*/
+void NahsBricksFeatureTemp::_convert(uint8_t bus, const uint8_t* addr) {
+    _oneWire[bus].reset();
+    if (addr == nullptr) _oneWire[bus].skip();
+    else _oneWire[bus].select(addr);
+    _oneWire[bus].write(OW_CONVERT_T, (RTCdata->parasiteBuses & (1 << bus)) ? 1 : 0);
+}
+
+/*
+Helper to get the value of the configuration register of a DS18B20 for precision
+*/
+uint8_t NahsBricksFeatureTemp::_precisionToConfig(uint8_t precision) {
+    return ((precision - 9) << 5) | 0x1F;
+}
+
+/*
+Helper to check if a sensor (identified by index in RTCmem) has a configuration register, which every supported family but the DS18S20 has
+*/
+bool NahsBricksFeatureTemp::_hasConfigRegister(uint8_t sensor_index) {
+    return _getSensorAddr(sensor_index)[0] != DS18S20MODEL;
+}
+
+/*
+Helper to configure the precision of sensors (bitmask of sensor indexes). The configuration register is read first (unless it
+was already read during this wake) and only sensors running with a different precision are written (which includes a copy to their EEPROM).
+*/
+void NahsBricksFeatureTemp::_transmitPrecisionToSensors(uint64_t sensors) {
+    ScratchPad scratchPad;
+    for (uint8_t i = 0; i < RTCdata->sensorCount; ++i) {
+        if (!(sensors & ((uint64_t)1 << i))) continue;
+        if (!(_sensorRegsRead & ((uint64_t)1 << i))) {
+            if (!_getSensorBus(i).isConnected(_getSensorAddr(i), scratchPad)) {
+                _countReadError(i);
+                continue;
+            }
+            memcpy(_sensorRegs[i], scratchPad + OW_SCRATCHPAD_TH, sizeof(_sensorRegs[i]));
+            _sensorRegsRead |= (uint64_t)1 << i;
+        }
+        uint8_t* regs = _sensorRegs[i];  // TH, TL and configuration register
+        uint8_t config = _precisionToConfig(_getPrecision(i));
+        if (_hasConfigRegister(i) && regs[2] != config) _writeScratchpad(i, regs[0], regs[1], config, true);
+        PRdata->precision[i] = (_getPrecision(i) << 4) | _getPrecision(i);
+    }
+}
+
+/*
+Helper to start the conversion on all OneWire buses back-to-back (so they convert in parallel),
+the deadline follows the slowest sensor (plus 1ms as millis() only counts whole milliseconds)
+*/
+void NahsBricksFeatureTemp::_startConversion() {
+    uint8_t slowest = 0;
+    for (uint8_t i = 0; i < RTCdata->sensorCount; ++i) slowest = max(slowest, _getActivePrecision(i));
+    if (slowest == 0) {
+        _DS18B20ReadyAt = millis();
+        return;
+    }
+    for (uint8_t b = 0; b < ONEWIRE_BUS_COUNT; ++b) {
+        if (SAdata->busSensorCount[b] == 0) continue;
+        _convert(b);
+    }
+    _DS18B20ReadyAt = millis() + _DS18B20[0].millisToWaitForConversion(slowest) + 1;
+}
+
+/*
+Helper to wait until the conversion started by _startConversion is finished on all OneWire buses
+*/
+void NahsBricksFeatureTemp::_waitForConversion() {
+    uint32_t remaining = _msUntil(_DS18B20ReadyAt);
+    if (remaining > 0) delay(remaining);  // sleep until the deadline instead of polling the bus
+    for (uint8_t b = 0; b < ONEWIRE_BUS_COUNT; ++b) {
+        if (SAdata->busSensorCount[b] == 0 || (RTCdata->parasiteBuses & (1 << b))) continue;  // parasite powered sensors can not signal completion
+        while(!_DS18B20[b].isConversionComplete()) delay(1);  // only loops if a sensor is slower than its datasheet
+    }
+}
+
+/*
+Helper to wait until the conversion triggered on the connected single-chip sensors is finished, they NACK reads before
+*/
+void NahsBricksFeatureTemp::_waitForI2CConversion() {
+    for (uint8_t k = 0; k < I2CSensors::COUNT; ++k) {
+        if (!_i2cSensors.isConnected(k)) continue;
+        uint32_t remaining = _msUntil(_i2cSensors.getReadyAt(k));
+        if (remaining > 0) delay(remaining);
+    }
+}
+
+/*
+Helper to calculate the milliseconds left until deadline (which is a millis() value) is reached
+*/
+uint32_t NahsBricksFeatureTemp::_msUntil(unsigned long deadline) {
+    long remaining = (long)(deadline - millis());
+    if (remaining > 0) return remaining;
+    return 0;
+}
+
+/*
+Helper to start a new telemetry window (min, max and error counters), on cold boot the averages are dropped as well
+*/
+void NahsBricksFeatureTemp::_resetTiming(bool coldBoot) {
+#if TEMP_TELEMETRY
+    for (uint8_t p = 0; p < TIMING_PHASE_COUNT; ++p) {
+        TMdata->phase[p].min = UINT32_MAX;
+        TMdata->phase[p].max = 0;
+        if (coldBoot) TMdata->phase[p].avg = 0;
+    }
+    TMdata->busErrors = 0;
+    TMdata->crcErrors = 0;
+    TMdata->powerOnErrors = 0;
+    for (uint8_t ch = 0; ch < CHANNEL_COUNT; ++ch) TMdata->readErrors[ch] = 0;
+#else
+    (void)coldBoot;
+#endif
+}
+
+/*
+Helper to add the duration (in microseconds) of a wake cycle phase to the timing telemetry
+*/
+void NahsBricksFeatureTemp::_recordTiming(uint8_t phase, uint32_t duration) {
+#if TEMP_TELEMETRY
+    _PhaseTiming& timing = TMdata->phase[phase];
+    if (timing.avg == 0) timing.avg = duration;
+    else timing.avg = timing.avg - timing.avg / 8 + duration / 8;
+    if (duration < timing.min) timing.min = duration;
+    if (duration > timing.max) timing.max = duration;
+#else
+    (void)phase;
+    (void)duration;
+#endif
+}
+
+/*
+Helper to count a failed scratchpad read of a sensor, a reset of it's bus tells a missing presence pulse from a CRC mismatch
+*/
+void NahsBricksFeatureTemp::_countReadError(uint8_t sensor_index) {
+    _countReadError(sensor_index, _oneWire[_sensorBus[sensor_index]].reset() ? READ_ERROR_CRC : READ_ERROR_BUS);
+}
+
+/*
+Helper to count a failed read (error as returned by _readTempRaw) of a channel
+*/
+void NahsBricksFeatureTemp::_countReadError(uint8_t channel, uint8_t error) {
+#if TEMP_TELEMETRY
+    if (TMdata->readErrors[channel] < UINT8_MAX) ++TMdata->readErrors[channel];
+    uint16_t* counter = nullptr;
+    if (error == READ_ERROR_BUS) counter = &TMdata->busErrors;
+    else if (error == READ_ERROR_CRC) counter = &TMdata->crcErrors;
+    else if (error == READ_ERROR_POWER_ON) counter = &TMdata->powerOnErrors;
+    if (counter != nullptr && *counter < UINT16_MAX) ++*counter;
+#else
+    (void)channel;
+    (void)error;
+#endif
+}
+
+/*
+Helper to print Feature submenu during BrickSetup
+*/
+void NahsBricksFeatureTemp::_printMenu() {
+    Serial.println("1) Identify sensor");
+    Serial.println("2) Read sensors (raw)");
+    Serial.println("3) Read sensors (with corr)");
+    Serial.println("4) Set default precision");
+    Serial.println("5) Set sensor corr");
+    Serial.println("6) Delete sensor corr");
+    Serial.println("7) Set sensor calibration (two-point)");
+    Serial.println("8) Bulk calibration of all sensors");
+    Serial.println("9) Return to MainMenu");
+}
+
+/*
+BrickSetup function to identify a sensor by touching it
+*/
+void NahsBricksFeatureTemp::_identifySensor() {
+    Serial.println("Reading initial Temperatures...");
+    _startConversion();
+    _waitForConversion();
+    int32_t raw;
+    float iniTemps[RTCdata->sensorCount];
+    for(uint8_t i = 0; i < RTCdata->sensorCount; i++) iniTemps[i] = (_readTempRaw(i, &raw) == READ_OK) ? _rawToC(raw) : NAN;
+    float iniTempsI2C[I2CSensors::COUNT];
+    for (uint8_t k = 0; k < I2CSensors::COUNT; ++k) {
+        if (_i2cSensors.isConnected(k)) _i2cSensors.getT(k);  // dummy read to be able to trigger an new conversion
+    }
+    _i2cSensors.trigger();
+    _waitForI2CConversion();
+    for (uint8_t k = 0; k < I2CSensors::COUNT; ++k) {
+        if (_i2cSensors.isConnected(k)) iniTempsI2C[k] = _i2cSensors.getT(k);
+    }
+
+    Serial.println("Hit <enter> to start identification");
+    SerHelp.readLine();
+    Serial.println("--------------------");
+    bool finished = false;
+    for(uint8_t w = 0; w < 20; w++) {
+        _startConversion();
+        _waitForConversion();
+        _i2cSensors.trigger();
+        _waitForI2CConversion();
+        for (uint8_t k = 0; k < I2CSensors::COUNT; ++k) {
+            if (!_i2cSensors.isConnected(k)) continue;
+            if((_i2cSensors.getT(k) - iniTempsI2C[k]) >= 2) {  // false if any of both reads failed (NAN)
+                Serial.println();
+                Serial.print("ID of Sensor is: ");
+                Serial.println(_i2cSensors.getID(k));
+                finished = true;
+            }
+        }
+        for(uint8_t i = 0; i < RTCdata->sensorCount; i++) {
+            if (_readTempRaw(i, &raw) != READ_OK) continue;
+            if((_rawToC(raw) - iniTemps[i]) >= 2) {
+                Serial.println();
+                Serial.print("ID of Sensor is: ");
+                Serial.println(_getSensorID(i));
+                finished = true;
+                break;
+            }
+        }
+        if(finished) break;
+        Serial.print('.');
+        delay(300);
+    }
+    if(!finished) {
+        Serial.println("\nNo Sensor could be identified...");
+    }
+}
+
+/*
+BrickSetup function to do a temp-reading on all sensors (and put it out WITHOUT correction value)
+*/
+void NahsBricksFeatureTemp::_readSensorsRaw() {
+    Serial.println("Requesting Temperatures...");
+    _startConversion();
+    _waitForConversion();
+    for (uint8_t k = 0; k < I2CSensors::COUNT; ++k) {
+        if (_i2cSensors.isConnected(k)) _i2cSensors.getT(k);  // dummy read to be able to trigger an new conversion
+    }
+    _i2cSensors.trigger();
+    _waitForI2CConversion();
+    for (uint8_t k = 0; k < I2CSensors::COUNT; ++k) {
+        if (!_i2cSensors.isConnected(k)) continue;
+        Serial.print(_i2cSensors.getID(k));
+        Serial.print(": ");
+        float t = _i2cSensors.getT(k);
+        if (isnan(t)) _printReadError(READ_ERROR_NO_DATA);
+        else Serial.println(t);
+    }
+    for(uint8_t i = 0; i < RTCdata->sensorCount; ++i) {
+        Serial.print(_getSensorID(i));
+        Serial.print(": ");
+        int32_t raw;
+        uint8_t error = _readTempRaw(i, &raw);
+        if (error != READ_OK) _printReadError(error);
+        else Serial.println(_rawToC(raw));
+    }
+}
+
+/*
+BrickSetup function to do a temp-reading on all sensors (and put it out WITH correction value)
+*/
+void NahsBricksFeatureTemp::_readSensorsCorr() {
+    Serial.println("Requesting Temperatures...");
+    _startConversion();
+    _waitForConversion();
+    for (uint8_t k = 0; k < I2CSensors::COUNT; ++k) {
+        if (_i2cSensors.isConnected(k)) _i2cSensors.getT(k);  // dummy read to be able to trigger an new conversion
+    }
+    _i2cSensors.trigger();
+    _waitForI2CConversion();
+    for (uint8_t k = 0; k < I2CSensors::COUNT; ++k) {
+        if (!_i2cSensors.isConnected(k)) continue;
+        Serial.print(_i2cSensors.getID(k));
+        Serial.print(": ");
+        float t = _i2cSensors.getT(k);
+        if (isnan(t)) _printReadError(READ_ERROR_NO_DATA);
+        else Serial.println(_rawToC(_calibrate(_cToRaw(t), _i2cSensors.getCorr(k), _i2cSensors.getGain(k))));
+    }
+    for(uint8_t i = 0; i < RTCdata->sensorCount; ++i) {
+        Serial.print(_getSensorID(i));
+        Serial.print(": ");
+        int32_t raw;
+        uint8_t error = _readTempRaw(i, &raw);
+        if (error != READ_OK) _printReadError(error);
+        else Serial.println(_rawToC(_calibrate(raw, SCdata->sensorCorr[i], SCdata->sensorGain[i])));
+    }
+}
+
+/*
+BrickSetup function to set the default precision
+*/
+void NahsBricksFeatureTemp::_setDefaultPrecision() {
+    Serial.print("Enter precision (8 to 12): ");
+    uint8_t input = SerHelp.readLine().toInt();
+    if (input < 8 || input > 12) {
+        Serial.println("Invalid precision!");
+        return;
+    }
+    FSdata["sPrec"] = input;
+    RTCdata->sensorPrecision = input;
+    _loadSensorPrecisions();
+    Serial.println("Configuring sensors...");
+    _transmitPrecisionToSensors();
+    Serial.print("Set precision to: ");
+    Serial.println(input);
+}
+
+/*
+BrickSetup function to set a default correction value for a sensor
+*/
+void NahsBricksFeatureTemp::_setDefaultCorr() {
+    Serial.print("Enter sensor ID: ");
+    String addr = SerHelp.readLine();
+    Serial.print("Enter correction value: ");
+    float corr = SerHelp.readLine().toFloat();
+    int16_t rawCorr;
+    if (!_cToCorr(corr, &rawCorr)) {
+        Serial.println("Invalid correction value!");
+        return;
+    }
+
+    int16_t record = _findCorrRecord(addr.c_str());
+    if (!_editCorrTable(1)) {
+        Serial.println("Out of memory!");
+        return;
+    }
+    _setCalibration(addr.c_str(), rawCorr, (record >= 0) ? _getGainRecord(record) : 0);  // gain is kept
+    if (!_saveCorrTable()) {
+        Serial.println("Failed to store correction value!");
+        return;
+    }
+    Serial.print("Set correction value of ");
+    Serial.print(addr);
+    Serial.print(" to ");
+    Serial.println(corr);
+}
+
+/*
+BrickSetup function to delete a default correction value for a sensor
+*/
+void NahsBricksFeatureTemp::_deleteDefaultCorr() {
+    Serial.print("Enter sensor ID: ");
+    String addr = SerHelp.readLine();
+
+    int8_t channel = _findChannel(addr.c_str());
+    if (channel >= 0) {
+        _setChannelCorr(channel, 0);
+        _setChannelGain(channel, 0);
+    }
+
+    if (!_editCorrTable(0)) {
+        Serial.println("Out of memory!");
+        return;
+    }
+    _removeCorr(addr.c_str());
+    if (!_saveCorrTable()) {
+        Serial.println("Failed to delete correction value!");
+        return;
+    }
+    Serial.print("Deleted correction value of ");
+    Serial.println(addr);
+}
+
+
+/*
+BrickSetup function to calibrate gain and correction of a sensor from two points (raw reading and reference temperature each)
+*/
+void NahsBricksFeatureTemp::_setTwoPointCalibration() {
+    Serial.print("Enter sensor ID: ");
+    String addr = SerHelp.readLine();
+    Serial.print("Enter raw reading of first point: ");
+    float raw1 = SerHelp.readLine().toFloat();
+    Serial.print("Enter reference temperature of first point: ");
+    float ref1 = SerHelp.readLine().toFloat();
+    Serial.print("Enter raw reading of second point: ");
+    float raw2 = SerHelp.readLine().toFloat();
+    Serial.print("Enter reference temperature of second point: ");
+    float ref2 = SerHelp.readLine().toFloat();
+
+    int16_t gain;
+    if (raw1 == raw2 || !_factorToGain((ref2 - ref1) / (raw2 - raw1), &gain)) {
+        Serial.println("Invalid points!");
+        return;
+    }
+    float corr = ref1 - raw1 * _gainToFactor(gain);
+    int16_t rawCorr;
+    if (!_cToCorr(corr, &rawCorr)) {
+        Serial.println("Invalid points!");
+        return;
+    }
+    if (!_editCorrTable(1)) {
+        Serial.println("Out of memory!");
+        return;
+    }
+    _setCalibration(addr.c_str(), rawCorr, gain);
+    if (!_saveCorrTable()) {
+        Serial.println("Failed to store calibration!");
+        return;
+    }
+    Serial.print("Set calibration of ");
+    Serial.print(addr);
+    Serial.print(" to gain ");
+    Serial.print(_gainToFactor(gain), 5);
+    Serial.print(" and correction ");
+    Serial.println(corr);
+}
+
+/*
+BrickSetup function to calibrate all sensors at once: every sensor is sampled N times and gets the correction
+that moves it's mean onto the reference (a temperature or the mean of a reference sensor), gains are kept
+*/
+void NahsBricksFeatureTemp::_bulkCalibration() {
+    Serial.print("Enter reference temperature or ID of reference sensor: ");
+    String ref = SerHelp.readLine();
+    int8_t refChannel = _findChannel(ref.c_str());
+    if (refChannel < 0 && (ref.length() == 0 || !((ref[0] >= '0' && ref[0] <= '9') || ref[0] == '-' || ref[0] == '.'))) {
+        Serial.println("Invalid reference!");
+        return;
+    }
+    Serial.print("Enter number of samples (2 to 100): ");
+    uint8_t samples = constrain(SerHelp.readLine().toInt(), 2, 100);
+
+    // sample with a lower precision to speed up conversion (only written to the scratchpads)
+    uint8_t precisions[MAX_TEMP_SENSORS_COUNT];
+    for (uint8_t i = 0; i < RTCdata->sensorCount; ++i) {
+        precisions[i] = PRdata->precision[i];
+        if (_writeVolatilePrecision(i, CALIBRATION_PRECISION)) PRdata->precision[i] = (CALIBRATION_PRECISION << 4) | _getPrecision(i);
+    }
+
+    // valid samples, mean and sum of squared deviations per channel (Welford), in degree celsius without calibration
+    uint8_t n[CHANNEL_COUNT] = {};
+    float mean[CHANNEL_COUNT] = {};
+    float m2[CHANNEL_COUNT] = {};
+    Serial.print("Sampling");
+    for (uint8_t s = 1; s <= samples; ++s) {
+        _startConversion();
+        for (uint8_t k = 0; k < I2CSensors::COUNT; ++k) {
+            if (_i2cSensors.isConnected(k)) _i2cSensors.getT(k);  // dummy read to be able to trigger an new conversion
+        }
+        _i2cSensors.trigger();
+        _waitForConversion();
+        _waitForI2CConversion();
+        for (uint8_t ch = 0; ch < CHANNEL_COUNT; ++ch) {
+            if (!_isChannelActive(ch)) continue;
+            int32_t raw;
+            float t = NAN;  // failed reads are NAN
+            if (ch >= I2C_CHANNEL) t = _i2cSensors.getT(ch - I2C_CHANNEL);
+            else if (_readTempRaw(ch, &raw) == READ_OK) t = _rawToC(raw);
+            if (isnan(t)) continue;  // failed reads are skipped
+            float delta = t - mean[ch];
+            mean[ch] += delta / ++n[ch];
+            m2[ch] += delta * (t - mean[ch]);
+        }
+        Serial.print('.');
+    }
+    Serial.println();
+
+    for (uint8_t i = 0; i < RTCdata->sensorCount; ++i) {
+        if (_writeVolatilePrecision(i, precisions[i] >> 4)) PRdata->precision[i] = precisions[i];
+    }
+
+    if (refChannel >= 0 && n[refChannel] < 2) {
+        Serial.println("Reference sensor delivered less than 2 valid samples!");
+        return;
+    }
+    float refTemp = ref.toFloat();
+    if (refChannel >= 0) refTemp = mean[refChannel] * _gainToFactor(_getChannelGain(refChannel)) + _rawToC(_getChannelCorr(refChannel));
+    float corrs[CHANNEL_COUNT];
+    for (uint8_t ch = 0; ch < CHANNEL_COUNT; ++ch) {
+        if (!_isChannelActive(ch)) continue;
+        Serial.print(_getChannelID(ch));
+        if (n[ch] < 2) {  // channels without enough valid samples are not calibrated
+            Serial.print(": ");
+            Serial.print(n[ch]);
+            Serial.println(" valid samples, skipped");
+            continue;
+        }
+        corrs[ch] = refTemp - mean[ch] * _gainToFactor(_getChannelGain(ch));
+        Serial.print(": mean ");
+        Serial.print(mean[ch]);
+        Serial.print(" stddev ");
+        Serial.print(sqrtf(m2[ch] / (n[ch] - 1)));
+        Serial.print(" corr ");
+        Serial.print((ch == refChannel) ? _rawToC(_getChannelCorr(ch)) : corrs[ch]);
+        int16_t corr;
+        if (ch != refChannel && !_cToCorr(corrs[ch], &corr)) Serial.print(" out of range, skipped");
+        Serial.println();
+    }
+
+    Serial.print("Store corrections (y/n)? ");
+    if (SerHelp.readLine() != "y") return;
+    if (!_editCorrTable(CHANNEL_COUNT)) {
+        Serial.println("Out of memory!");
+        return;
+    }
+    for (uint8_t ch = 0; ch < CHANNEL_COUNT; ++ch) {
+        int16_t corr;
+        if (!_isChannelActive(ch) || ch == refChannel || n[ch] < 2 || !_cToCorr(corrs[ch], &corr)) continue;
+        _setCalibration(_getChannelID(ch), corr, _getChannelGain(ch));
+    }
+    if (!_saveCorrTable()) {
+        Serial.println("Failed to store corrections!");
+        return;
+    }
+    Serial.println("Stored corrections of all sensors with valid samples and corrections in range");
+}
+
+/*
+BrickSetup helper to print a failed read (error as returned by _readTempRaw) instead of a temperature
+*/
+void NahsBricksFeatureTemp::_printReadError(uint8_t error) {
+    Serial.print("read failed (error ");
+    Serial.print(error);
+    Serial.println(")");
+}
 
 //------------------------------------------
 // globally predefined variable
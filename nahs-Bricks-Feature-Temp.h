@@ -5,45 +5,203 @@
 #include <ArduinoJson.h>
 #include <OneWire.h>
 #include <DallasTemperature.h>
-#include <nahs-Bricks-Lib-HDC1080.h>
-#include <nahs-Bricks-Lib-SHT4x.h>
+#include "nahs-Bricks-Feature-Temp-Sensors.h"
 #include <nahs-Bricks-Feature-BaseClass.h>
 #include <nahs-Bricks-Lib-RTCmem.h>
 #include <nahs-Bricks-Lib-FSmem.h>
 
+// RTCmem used by the feature: 68 bytes plus 14 bytes per DS18B20 sensor (180 bytes with the defaults), plus the optional blocks below.
+// An ESP8266 has 512 bytes of RTC user memory, shared with the Brick OS and the other features of the brick.
+
+// Number of DS18B20 sensors the feature can handle (DS18S20, DS1822 and DS1825 count as DS18B20), up to 64 if RTCmem allows
+#ifndef TEMP_MAX_SENSORS_COUNT
+#define TEMP_MAX_SENSORS_COUNT 8
+#endif
+
+// Optional blocks of RTCmem, set to 1 (or a number of slots) to build the mode in (RTCmem is reserved even while a mode is switched off),
+// costs are given per sensor (TEMP_MAX_SENSORS_COUNT) or per channel (TEMP_MAX_SENSORS_COUNT + 2 single-chip sensors)
+#ifndef TEMP_ADAPTIVE_PRECISION  // adaptive precision (feedback key tpa), 2 bytes per sensor (16 bytes with 8 sensors)
+#define TEMP_ADAPTIVE_PRECISION 0
+#endif
+#ifndef TEMP_FILTERING  // filtering across wakes (feedback keys tfm and tfn), 9 bytes per channel (92 bytes with 8 sensors, aligned)
+#define TEMP_FILTERING 0
+#endif
+#ifndef TEMP_TELEMETRY  // timing telemetry and read error counters (request 21), 66 bytes plus 1 byte per channel (76 bytes with 8 sensors)
+#define TEMP_TELEMETRY 0
+#endif
+#ifndef TEMP_BATCH_BUFFER_SLOTS  // readings the batch buffer can hold (feedback keys tbf and tbs), 4 bytes plus 2 bytes per reading (68 bytes with 32 slots)
+#define TEMP_BATCH_BUFFER_SLOTS 0
+#endif
+
+// Time (in ms after begin()) up to which failing DS18B20 reads are retried
+#ifndef TEMP_READ_RETRY_DEADLINE_MS
+#define TEMP_READ_RETRY_DEADLINE_MS 2000
+#endif
+
+// Number of OneWire buses (each on it's own pin, see setSensorsPin) the DS18B20 sensors are spread over
+#ifndef TEMP_ONEWIRE_BUS_COUNT
+#define TEMP_ONEWIRE_BUS_COUNT 1
+#endif
+
 class NahsBricksFeatureTemp : public NahsBricksFeatureBaseClass {
     private:  // Variables
-        static const uint16_t version = 1;
-        static const uint8_t MAX_TEMP_SENSORS_COUNT = 8;
-        bool _HDC1080_connected = false;
-        bool _SHT4x_connected = false;
+        static const uint16_t version = 2;
+        static const uint8_t MAX_TEMP_SENSORS_COUNT = TEMP_MAX_SENSORS_COUNT;
+        static_assert(MAX_TEMP_SENSORS_COUNT <= 64, "TEMP_MAX_SENSORS_COUNT needs to be 64 or less");
+        static const uint8_t ONEWIRE_BUS_COUNT = TEMP_ONEWIRE_BUS_COUNT;
+        static_assert(ONEWIRE_BUS_COUNT >= 1 && ONEWIRE_BUS_COUNT <= 8, "TEMP_ONEWIRE_BUS_COUNT needs to be between 1 and 8");
+        static const uint8_t SENSOR_PACKED_SIZE = 7;  // bytes of a DeviceAddress without CRC (family code and serial)
+        typedef TempSensorRegistry<TempI2CSensor<TempDriverHDC1080>, TempI2CSensor<TempDriverSHT4x>> I2CSensors;  // single-chip sensors supported by the feature
+        static const uint8_t I2C_CHANNEL = MAX_TEMP_SENSORS_COUNT;  // index of first single-chip sensor in per channel arrays
+        static const uint8_t CHANNEL_COUNT = MAX_TEMP_SENSORS_COUNT + I2CSensors::COUNT;
+        static const uint8_t BATCH_BUFFER_SLOTS = TEMP_BATCH_BUFFER_SLOTS;  // number of readings the batch buffer in RTCmem can hold (shared by all channels)
+        static const int16_t NOTHING_SENT = INT16_MIN;  // marks a channel in _DBdata::lastSent that has not been delivered yet (or a missing reading in _BTdata)
+        static const int32_t NO_READING = INT32_MIN;  // marks a channel in readings that was not read during this wake
+        static const uint8_t READ_OK = 0;  // results of a read, NO_READING + error marks a failed read in readings (delivered as error code)
+        static const uint8_t READ_ERROR_BUS = 1;  // no presence pulse on the OneWire bus
+        static const uint8_t READ_ERROR_CRC = 2;  // scratchpad failed the CRC check
+        static const uint8_t READ_ERROR_POWER_ON = 3;  // scratchpad still holds the power-on value (sensor lost power or did not convert)
+        static const uint8_t READ_ERROR_NO_DATA = 4;  // single-chip sensor did not deliver a (valid) reading
+        static const int32_t READ_ERROR_MARK = NO_READING + 16;  // readings up to this value are no temperatures
+        static const uint8_t READ_RETRIES = 2;  // max number of retries of a failed DS18B20 read
+        static const uint32_t READ_RETRY_DEADLINE_MS = TEMP_READ_RETRY_DEADLINE_MS;  // retries are only done if they finish within this many ms after begin()
+        static const int16_t ADAPTIVE_STEADY_DELTA = 32;  // change per wake (in 1/128 degree celsius) below which adaptive precision uses 9 bit
+        static const int16_t ADAPTIVE_MOVING_DELTA = 128;  // change per wake (in 1/128 degree celsius) below which adaptive precision uses 10 bit
+        static const uint8_t OW_CONVERT_T = 0x44;
+        static const uint8_t OW_WRITE_SCRATCHPAD = 0x4E;
+        static const uint8_t OW_COPY_SCRATCHPAD = 0x48;
+        static const uint8_t OW_COPY_MS = 10;  // duration of a copy of the scratchpad to EEPROM
+        static const uint8_t OW_READ_SCRATCHPAD = 0xBE;
+        static const uint8_t OW_SCRATCHPAD_TEMP_LSB = 0;  // index of temperature LSB in scratchpad (MSB follows)
+        static const uint8_t OW_SCRATCHPAD_TH = 2;  // index of TH register (high alarm threshold) in scratchpad
+        static const uint8_t OW_SCRATCHPAD_TL = 3;  // index of TL register (low alarm threshold) in scratchpad
+        static const uint8_t OW_SCRATCHPAD_CONFIG = 4;  // index of configuration register in scratchpad
+        static const int32_t POWER_ON_RAW = 85 * 128;  // value (in 1/128 degree celsius) of the scratchpad after power-on
+        static const uint8_t OW_SCRATCHPAD_COUNT_REMAIN = 6;  // index of COUNT_REMAIN in scratchpad of a DS18S20 (fraction of it's 0.5 degree reading)
+        static const uint8_t OW_SCRATCHPAD_COUNT_PER_C = 7;  // index of COUNT_PER_C in scratchpad of a DS18S20 (always 16)
+        static const uint8_t CORR_KEY_CHARS = 16;  // sensor ID (up to 8 bytes as hex) padded with '-' to a fixed width
+        static const uint8_t CORR_RECORD_CHARS = CORR_KEY_CHARS + 8;  // key followed by correction (in 1/128 degree celsius) and gain deviation, both int16 as hex
+        static const uint8_t CORR_MAX_C = 255;  // max absolute correction (in degree celsius), keeps it in the int16 of the correction table
+        static const uint8_t GAIN_SHIFT = 15;  // gain is kept as deviation from 1 in 1/32768 (so 0 is no gain correction)
+        static const uint8_t CALIBRATION_PRECISION = 11;  // precision of DS18B20 sensors during bulk calibration (0.125 degree celsius in 375ms)
+        static const uint8_t FILTER_OFF = 0;  // filter modes (feedback key tfm)
+        static const uint8_t FILTER_MEDIAN = 1;
+        static const uint8_t FILTER_EMA = 2;
+        static const uint8_t FILTER_MEDIAN_MAX = 5;  // max number of readings (including the current one) a median is taken over
+        static const uint8_t FILTER_EMA_MAX_SHIFT = 4;  // EMA weights the current reading with 1/2^filterParam, so 1/16 at least
+        static const uint8_t EMA_FRACTION_BITS = 8;  // extra fractional bits of EMA state
+        static const uint8_t TIMING_BEGIN = 0;  // phases of a wake cycle with timing telemetry (index in _TMdata::phase)
+        static const uint8_t TIMING_SEARCH = 1;
+        static const uint8_t TIMING_START = 2;
+        static const uint8_t TIMING_WAIT = 3;
+        static const uint8_t TIMING_JSON = 4;
+        static const uint8_t TIMING_PHASE_COUNT = 5;
+        static const uint8_t TIMING_REQUEST = 21;  // request code (in r array) to deliver the timing telemetry
+        static const uint8_t JSON_FLOAT_CHARS = 12;  // max serialized length of a temperature (1/128 resolution, e.g. -127.9921875) or gain
+        bool _sensorsDiscovered = false;  // true if sensors got (re)discovered during this wake and need to be configured
+        uint64_t _newSensors = 0;  // bitmask of sensor indexes added by _updateSensors during this wake (which need to be configured)
         typedef struct {
-            float HDC1080Corr;  // holds correction value for HDC1080 if connected
-            HDC1080_SerialNumber HDC1080SN;  // holds SN of HDC1080 Sensor if connected
             uint8_t sensorCount;  // Holds number of currently connected temp-sensors
             uint8_t sensorPrecision;
             bool precisionRequested;
             bool sensorCorrRequested;
+            bool timingRequested;
+            bool rescanRequested;  // if true, the next wake searches the OneWire buses for added, removed or replaced sensors
+            uint8_t parasiteBuses;  // bitmask of OneWire buses with parasite powered sensors
+            uint8_t sensorsAdded;  // number of sensors added since last delivery of topology changes
+            uint8_t sensorsRemoved;  // number of sensors removed since last delivery of topology changes
+            uint16_t rescanInterval;  // number of wakes between periodic full searches (0 = disabled)
+            uint16_t wakesSinceScan;  // number of wakes since the last discovery of sensors
+            uint16_t deadband;  // in 1/100 degree celsius, readings that changed less are not delivered (0 = disabled)
+            uint16_t maxSilence;  // number of wakes after which all readings are delivered regardless of deadband (0 = never)
+            uint16_t wakesSinceFullReport;
+            bool prearmConversion;  // if true, end() starts the conversion for the next wake (externally powered sensors only)
+            bool conversionPrearmed;  // true if the sensors hold readings of a conversion started in end()
+            bool adaptivePrecision;  // if true, the precision of stable sensors is lowered to speed up conversion
+            bool centiFormat;  // if true, readings are delivered as integer in 1/100 degree celsius instead of float
+            uint8_t filterMode;  // FILTER_OFF, FILTER_MEDIAN or FILTER_EMA
+            uint8_t filterParam;  // number of readings for median or weight shift for EMA
+            bool alarmMode;  // if true, only DS18B20 sensors flagged by an alarm search are read and delivered
+            bool compactPayload;  // if true, the channel table is delivered (th and ti) and compact payload is used once BrickServer acknowledged it
+            uint32_t ackedTableHash;  // hash of the channel table BrickServer acknowledged, enables compact payload while it matches (0 = none)
+            uint8_t batchSize;  // number of samples buffered per batch (0 = sample every wake)
+            uint8_t batchInterval;  // number of wakes between deliveries in batching mode (0 or 1 = batching disabled)
+            uint8_t batchCount;  // number of samples currently in batch buffer
+            uint8_t wakesSinceFlush;
         } _RTCdata;
         typedef struct {
-            float sensorCorr[MAX_TEMP_SENSORS_COUNT];  // holds currently used sensor correction values
+            int16_t sensorCorr[MAX_TEMP_SENSORS_COUNT];  // holds currently used sensor correction values (in 1/128 degree celsius)
+            int16_t sensorGain[MAX_TEMP_SENSORS_COUNT];  // holds currently used deviations of sensor gains from 1 (in 1/32768)
         } _SCdata;
         typedef struct {
-            DeviceAddress sensorAddr[4];  // holds addresses of currently connected sensors
+            uint8_t sensorAddr[MAX_TEMP_SENSORS_COUNT][SENSOR_PACKED_SIZE];  // holds addresses (without CRC) of currently connected sensors
+            uint8_t busSensorCount[ONEWIRE_BUS_COUNT];  // number of sensors per OneWire bus (sensors are ordered by bus)
         } _SAdata;
         typedef struct {
-            float SHT4xCorr;  // holds correction value for SHT4x if connected
-            SHT4x_SerialNumber SHT4xSN;  // holds SN of SHT4x Sensor if connected
-        } _SHTdata;
+            uint8_t precision[MAX_TEMP_SENSORS_COUNT];  // per sensor: configured precision in lower, active precision in upper nibble
+#if TEMP_ADAPTIVE_PRECISION
+            int16_t lastReading[MAX_TEMP_SENSORS_COUNT];  // last reading (in 1/128 degree celsius) for adaptive precision
+#endif
+        } _PRdata;
+        typedef struct {
+            int16_t lastSent[CHANNEL_COUNT];  // last delivered reading per channel in 1/100 degree celsius
+        } _DBdata;
+        typedef struct {
+            uint32_t min;  // in microseconds (UINT32_MAX if phase was not run since last delivery)
+            uint32_t avg;  // exponential moving average (weight 1/8) in microseconds
+            uint32_t max;  // in microseconds
+        } _PhaseTiming;
+        typedef struct {
+            _PhaseTiming phase[TIMING_PHASE_COUNT];  // min and max since last delivery, avg since cold boot
+            uint16_t busErrors;  // failed scratchpad reads without presence pulse on the bus since last delivery
+            uint16_t crcErrors;  // failed scratchpad reads with a presence pulse (CRC mismatch) since last delivery
+            uint16_t powerOnErrors;  // scratchpad reads holding the power-on value since last delivery
+            uint8_t readErrors[CHANNEL_COUNT];  // failed reads per channel since last delivery (including retried ones)
+        } _TMdata;
+        typedef union {
+            int16_t history[FILTER_MEDIAN_MAX - 1];  // median: previous readings (in 1/128 degree celsius), newest first
+            int32_t ema;  // EMA: average (in 1/128 degree celsius) with EMA_FRACTION_BITS extra fractional bits
+        } _ChannelFilter;
+        typedef struct {
+            _ChannelFilter channel[CHANNEL_COUNT];
+            uint8_t samples[CHANNEL_COUNT];  // number of readings held in filter state per channel
+        } _FLdata;
+#if TEMP_BATCH_BUFFER_SLOTS > 0
+        typedef struct {
+            uint32_t tableHash;  // hash of the channel table the buffered samples are laid out by
+            int16_t values[BATCH_BUFFER_SLOTS];  // buffered readings in 1/100 degree celsius, one sample after the other
+        } _BTdata;
+#endif
         _SCdata* SCdata = RTCmem.registerData<_SCdata>();
-        _SAdata* SAdata1 = RTCmem.registerData<_SAdata>();
-        _SAdata* SAdata2 = RTCmem.registerData<_SAdata>();
+        _SAdata* SAdata = RTCmem.registerData<_SAdata>();
         _RTCdata* RTCdata = RTCmem.registerData<_RTCdata>();
-        _SHTdata* SHTdata = RTCmem.registerData<_SHTdata>();
+        I2CSensors _i2cSensors;  // registers RTCmem of every single-chip sensor
+        _DBdata* DBdata = RTCmem.registerData<_DBdata>();
+#if TEMP_BATCH_BUFFER_SLOTS > 0
+        _BTdata* BTdata = RTCmem.registerData<_BTdata>();
+#endif
+        _PRdata* PRdata = RTCmem.registerData<_PRdata>();
+#if TEMP_TELEMETRY
+        _TMdata* TMdata = RTCmem.registerData<_TMdata>();
+#endif
+#if TEMP_FILTERING
+        _FLdata* FLdata = RTCmem.registerData<_FLdata>();
+#endif
         JsonObject FSdata = FSmem.registerData("t");
-        uint8_t _oneWirePin;
-        OneWire _oneWire;
-        DallasTemperature _DS18B20;
+        JsonObject CTdata = FSmem.registerData("tc");  // correction table, records sorted by key for binary search
+        uint8_t _oneWirePins[ONEWIRE_BUS_COUNT] = {};
+        OneWire _oneWire[ONEWIRE_BUS_COUNT];
+        DallasTemperature _DS18B20[ONEWIRE_BUS_COUNT];
+        DeviceAddress _sensorAddrs[MAX_TEMP_SENSORS_COUNT];  // full addresses of DS18B20 sensors, restored from RTCmem once per wake
+        uint8_t _sensorBus[MAX_TEMP_SENSORS_COUNT];  // OneWire bus of DS18B20 sensors, restored from RTCmem once per wake
+        char _sensorIDs[MAX_TEMP_SENSORS_COUNT][2 * sizeof(DeviceAddress) + 1];  // hex IDs of DS18B20 sensors, rendered once per wake
+        uint8_t _sensorRegs[MAX_TEMP_SENSORS_COUNT][3];  // TH, TL and configuration register of DS18B20 sensors, as read during this wake
+        uint64_t _sensorRegsRead = 0;  // bitmask of sensor indexes with valid _sensorRegs
+        uint32_t _tableHash = 0;  // hash of the IDs of all connected channels in channel order, calculated once per wake
+        unsigned long _begunAt = 0;  // millis() when begin() was called (the OS may have been awake for a while before)
+        unsigned long _DS18B20ReadyAt = 0;  // millis() when the DS18B20 conversion on all buses is finished
+        char* _corrEdit = nullptr;  // working copy of the correction table while it is edited, see _editCorrTable
+        uint16_t _corrEditInserts = 0;  // records that can still be inserted into _corrEdit
 
     public: // BaseClass implementations
         NahsBricksFeatureTemp();
@@ -59,13 +217,125 @@ class NahsBricksFeatureTemp : public NahsBricksFeatureBaseClass {
         void brickSetupHandover();
 
     public:  // Brick-Specific setter
-        void setSensorsPin(uint8_t pin);
+        void setSensorsPin(uint8_t pin, uint8_t bus = 0);
+
+    public:  // Scheduling helpers (for the OS to do other work while conversions are running)
+        bool isReady();
+        uint32_t msUntilReady();
+        bool isBatchFlushDue();
+
+    public:  // Payload sizing (for the OS to allocate a right-sized JsonDocument for deliver)
+        // capacity deliver() needs at most with all sensors connected and all requests pending (upper bound, see deliverCapacity)
+        static constexpr size_t maxDeliverCapacity() {
+            return JSON_ARRAY_SIZE(_deliverSlots(MAX_TEMP_SENSORS_COUNT, CHANNEL_COUNT, true, true, true, TEMP_TELEMETRY, CHANNEL_COUNT, true, BATCH_BUFFER_SLOTS, BATCH_BUFFER_SLOTS, true, false));
+        }
+        size_t deliverCapacity();
+        size_t deliverSize();
 
     private:  // internal Helpers
-        String _deviceAddrToString(uint8_t sensor_index);
-        String _deviceAddrToString(DeviceAddress deviceAddress);
-        float _getTempC(uint8_t sensor_index);
-        void _transmitPrecisionToSensors(bool inBackground);
+        /*
+        Number of json slots (members and array elements) deliver() adds at most, every channel is counted as delivered
+        (with the larger entry of a failed read, so this is exact only if every read fails).
+        IDs and keys are added without copies so they need no extra capacity.
+        */
+        static constexpr size_t _deliverSlots(uint8_t sensors, uint8_t channels, bool precision, bool corr, bool topology, bool timing,
+                                              uint8_t errorChannels, bool flush, uint8_t samples, uint16_t sampleValues, bool table, bool compact) {
+            return !flush ? 0 : (precision ? 2 + sensors * 4 : 0)  // wakes that only buffer readings deliver nothing, p and tps with [id, precision, active precision] per sensor
+                + (corr ? 2 * (1 + channels * 3) : 0)  // c and tg with [id, value] per channel
+                + (topology ? 3 : 0)  // tx
+                + (timing ? 1 + TIMING_PHASE_COUNT * 4 + 4 + 1 + errorChannels * 3 : 0)  // tt, te and tre
+                + (samples > 0 ? 1 + (compact ? 1 : 1 + channels) + samples * 2 + sampleValues : 0)  // tb
+                + (table ? 1 + (compact ? 0 : 1 + channels) : 0)  // th and ti
+                + 1 + channels * (compact ? 2 : 4);  // t ([id, value] or [id, null, error]) or tv (value or [error])
+        }
+
+        void _deliverRequested(JsonDocument* out_json);
+        void _discoverSensors();
+        void _updateSensors();
+        void _checkPowerSupply();
+        void _searchSensors();
+        bool _loadInventory();
+        void _storeInventory();
+        void _packSensorAddrs();
+        void _unpackSensorAddrs();
+        void _assignSensorBuses();
+        DallasTemperature& _getSensorBus(uint8_t sensor_index);
+        uint8_t* _getSensorAddr(uint8_t sensor_index);
+        const char* _getSensorID(uint8_t sensor_index);
+        void _renderSensorIDs();
+        const char* _corrTable();
+        void _corrKey(const char* id, char* key);
+        int16_t _findCorrRecord(const char* id);
+        int16_t _getCorrRecord(int16_t index);
+        int16_t _getGainRecord(int16_t index);
+        int16_t _decodeRecordField(int16_t index, uint8_t pos);
+        bool _editCorrTable(uint16_t inserts);
+        bool _saveCorrTable();
+        bool _storeCorr(const char* id, int16_t corr, int16_t gain);
+        void _removeCorr(const char* id);
+        void _migrateCorrMap();
+        void _hexEncode(const uint8_t* data, uint8_t len, char* out);
+        bool _hexDecode(const char* str, uint8_t* data, uint8_t len);
+        uint8_t _readTempRaw(uint8_t sensor_index, int32_t* raw);
+        uint8_t _readScratchpad(uint8_t sensor_index, bool skipRom, int32_t* raw);
+        bool _isReading(int32_t value);
+        float _rawToC(int32_t raw);
+        int32_t _cToRaw(float celsius);
+        int32_t _rawToCenti(int32_t raw);
+        int32_t _calibrate(int32_t raw, int16_t corr, int16_t gain);
+        float _gainToFactor(int16_t gain);
+        bool _factorToGain(float factor, int16_t* gain);
+        bool _cToCorr(float celsius, int16_t* corr);
+        void _setCalibration(const char* id, int16_t corr, int16_t gain);
+        void _readChannels(int32_t* values);
+        void _readDS18B20(int32_t* values);
+        uint64_t _searchAlarms();
+        bool _setAlarmThresholds(const char* id, int8_t low, int8_t high);
+        bool _isChannelActive(uint8_t channel);
+        const char* _getChannelID(uint8_t channel);
+        int16_t _getChannelCorr(uint8_t channel);
+        void _setChannelCorr(uint8_t channel, int16_t corr);
+        int16_t _getChannelGain(uint8_t channel);
+        void _setChannelGain(uint8_t channel, int16_t gain);
+        int8_t _findChannel(const char* id);
+        uint8_t _activeChannelCount();
+        uint32_t _calcTableHash();
+        bool _isCompact();
+        uint8_t _batchStep();
+#if TEMP_BATCH_BUFFER_SLOTS > 0
+        void _bufferReadings(int32_t* values);
+        void _flushBatch(JsonDocument* out_json);
+#endif
+        void _addReading(JsonArray t_array, const char* id, int32_t value, uint8_t channel, bool force);
+        uint8_t _getPrecision(uint8_t sensor_index);
+        uint8_t _getActivePrecision(uint8_t sensor_index);
+        void _loadSensorPrecisions();
+        void _loadSensorPrecision(uint8_t sensor_index);
+        void _loadChannelCalibration(uint8_t channel);
+#if TEMP_ADAPTIVE_PRECISION
+        void _adaptPrecision(int32_t* values);
+        void _restorePrecisions();
+#endif
+#if TEMP_FILTERING
+        void _resetFilters();
+        void _filterReadings(int32_t* values);
+        int32_t _filterMedian(uint8_t channel, int32_t value);
+        int32_t _filterEMA(uint8_t channel, int32_t value);
+#endif
+        bool _writeVolatilePrecision(uint8_t sensor_index, uint8_t precision);
+        void _writeScratchpad(uint8_t sensor_index, uint8_t th, uint8_t tl, uint8_t config, bool copy);
+        void _convert(uint8_t bus, const uint8_t* addr = nullptr);
+        uint8_t _precisionToConfig(uint8_t precision);
+        bool _hasConfigRegister(uint8_t sensor_index);
+        void _transmitPrecisionToSensors(uint64_t sensors = UINT64_MAX);
+        void _startConversion();
+        void _waitForConversion();
+        void _waitForI2CConversion();
+        uint32_t _msUntil(unsigned long deadline);
+        void _resetTiming(bool coldBoot);
+        void _recordTiming(uint8_t phase, uint32_t duration);
+        void _countReadError(uint8_t sensor_index);
+        void _countReadError(uint8_t channel, uint8_t error);
 
     private:  // BrickSetup Helpers
         void _printMenu();
@@ -75,6 +345,9 @@ class NahsBricksFeatureTemp : public NahsBricksFeatureBaseClass {
         void _setDefaultPrecision();
         void _setDefaultCorr();
         void _deleteDefaultCorr();
+        void _setTwoPointCalibration();
+        void _bulkCalibration();
+        void _printReadError(uint8_t error);
 };
 
 #if !defined(NO_GLOBAL_INSTANCES)
@@ -0,0 +1,93 @@
+/*
+Wake cycle benchmark: runs cold and warm wakes with 1 to TEMP_MAX_SENSORS_COUNT DS18B20 sensors (plus
+single-chip sensors) on simulated hardware and reports the time the brick is awake, the time spent on the
+buses, heap allocations, payload size and RTCmem usage.
+Bus timing follows the datasheets (standard speed OneWire, 100kHz I2C), CPU time of the ESP8266 is not part of it.
+*/
+
+#include <nahs-Bricks-Feature-Temp.h>
+#include "sim/sim.h"
+#include "sim/sim_brick.h"
+#include "sim/check.h"
+
+static const uint8_t WARM_WAKES = 10;
+
+struct Result {
+    uint64_t awakeUs;
+    uint64_t oneWireUs;
+    uint64_t i2cUs;
+    uint64_t allocations;
+    size_t jsonBytes;
+};
+
+static SimBrick brick;
+
+static Result runWake(JsonDocument& out, JsonDocument* in) {
+    sim::resetStats();
+    uint64_t allocations = sim::allocations;
+    Result r;
+    r.awakeUs = brick.cycle(out, in);
+    r.allocations = sim::allocations - allocations;
+    r.oneWireUs = sim::stats.oneWireUs;
+    r.i2cUs = sim::stats.i2cUs;
+    r.jsonBytes = measureJson(out);
+    return r;
+}
+
+static void printRow(const char* label, uint8_t sensors, bool i2c, const Result& r) {
+    printf("%-5s %3u %-4s %10.1f %10.1f %8.1f %7llu %6zu\n", label, sensors, i2c ? "yes" : "no",
+        r.awakeUs / 1000.0, r.oneWireUs / 1000.0, r.i2cUs / 1000.0, (unsigned long long)r.allocations, r.jsonBytes);
+}
+
+static void bench(uint8_t sensors, bool i2c) {
+    sim::reset();
+    FSmem.clear();
+    for (uint8_t i = 0; i < sensors; ++i) sim::addDS18B20(SimBrick::PIN, 0x1000 + i, 20 + i * 0.25f);
+    if (i2c) {
+        sim::addHDC1080(21.5f);
+        sim::addSHT4x(22.5f);
+    }
+    DynamicJsonDocument out(NahsBricksFeatureTemp::maxDeliverCapacity());
+    DynamicJsonDocument in(256);
+    in.createNestedArray("r").add(4);  // sensor corrections are requested on the first delivery, like BrickServer does
+
+    brick.powerOn();
+    Result cold = runWake(out, &in);
+    printRow("cold", sensors, i2c, cold);
+    CHECK(out["t"].size() == sensors + (i2c ? 2u : 0u), "%u sensors delivered", (unsigned)out["t"].size());
+
+    Result warm = {};
+    for (uint8_t w = 0; w < WARM_WAKES; ++w) {
+        Result r = runWake(out, nullptr);
+        CHECK(sim::stats.searches == 0, "warm wake searched the bus");
+        CHECK(sim::stats.eepromCopies == 0, "warm wake wrote the EEPROM");
+        CHECK(sim::stats.scratchpadWrites == 0, "warm wake wrote the scratchpad");
+        CHECK(sim::stats.convertTs == (sensors ? 1u : 0u), "%u Convert-T on a warm wake", sim::stats.convertTs);
+        warm.awakeUs += r.awakeUs;
+        warm.oneWireUs += r.oneWireUs;
+        warm.i2cUs += r.i2cUs;
+        warm.allocations += r.allocations;
+        warm.jsonBytes = r.jsonBytes;
+    }
+    warm.awakeUs /= WARM_WAKES;
+    warm.oneWireUs /= WARM_WAKES;
+    warm.i2cUs /= WARM_WAKES;
+    warm.allocations /= WARM_WAKES;
+    printRow("warm", sensors, i2c, warm);
+    CHECK(out["t"].size() == sensors + (i2c ? 2u : 0u), "%u sensors delivered", (unsigned)out["t"].size());
+}
+
+int main() {
+    printf("TEMP_MAX_SENSORS_COUNT: %u\n", (unsigned)TEMP_MAX_SENSORS_COUNT);
+    printf("maxDeliverCapacity: %zu bytes\n\n", NahsBricksFeatureTemp::maxDeliverCapacity());
+    printf("%-5s %3s %-4s %10s %10s %8s %7s %6s\n", "wake", "ds", "i2c", "awake[ms]", "1wire[ms]", "i2c[ms]", "allocs", "json");
+    const uint8_t counts[] = {1, 2, 4, 8, 16};
+    for (uint8_t n : counts) {
+        if (n > TEMP_MAX_SENSORS_COUNT) continue;
+        bench(n, false);
+    }
+    bench(TEMP_MAX_SENSORS_COUNT / 4, true);
+    bench(0, true);
+    printf("\nRTCmem used: %zu bytes\n", RTCmem.used());
+    return checkResult();
+}
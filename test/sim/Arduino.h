@@ -0,0 +1,119 @@
+#ifndef SIM_ARDUINO_H
+#define SIM_ARDUINO_H
+
+// Host stand-in for the parts of the Arduino core used by the feature, time is driven by the simulation clock (see sim.h)
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+
+#define HEX 16
+#define BIN 2
+#define DEC 10
+
+typedef uint8_t byte;
+
+/*
+Every non-empty String lives on the heap (like String of the Arduino core), so it shows up in sim::allocations
+*/
+class String {
+    public:
+        String(const char* str = "") : _str(str == nullptr ? "" : str) { _heap(); }
+        String(const std::string& str) : _str(str) { _heap(); }
+        String(const String& other) : _str(other._str) { _heap(); }
+        String(char c) : _str(1, c) { _heap(); }
+        String(int value, unsigned char base = DEC) : _str(_format((long long)value, base)) { _heap(); }
+        String(unsigned int value, unsigned char base = DEC) : _str(_format((long long)value, base)) { _heap(); }
+        String(long value, unsigned char base = DEC) : _str(_format((long long)value, base)) { _heap(); }
+        String(unsigned long value, unsigned char base = DEC) : _str(_format((long long)value, base)) { _heap(); }
+        String(float value, unsigned char decimals = 2) : _str(_format((double)value, decimals)) { _heap(); }
+        String(double value, unsigned char decimals = 2) : _str(_format((double)value, decimals)) { _heap(); }
+        String& operator=(const String& other) { _str = other._str; _heap(); return *this; }
+
+        const char* c_str() const { return _str.c_str(); }
+        unsigned int length() const { return _str.size(); }
+        char charAt(unsigned int index) const { return index < _str.size() ? _str[index] : 0; }
+        char operator[](unsigned int index) const { return charAt(index); }
+        long toInt() const { return atol(_str.c_str()); }
+        float toFloat() const { return atof(_str.c_str()); }
+        void trim() {
+            size_t first = _str.find_first_not_of(" \t\r\n");
+            size_t last = _str.find_last_not_of(" \t\r\n");
+            _str = (first == std::string::npos) ? "" : _str.substr(first, last - first + 1);
+        }
+        void toLowerCase() { for (char& c : _str) c = tolower(c); }
+        bool equalsIgnoreCase(const String& other) const { return strcasecmp(c_str(), other.c_str()) == 0; }
+        String& operator+=(const String& other) { _str += other._str; _heap(); return *this; }
+        String& operator+=(const char* other) { _str += other; _heap(); return *this; }
+        String& operator+=(char c) { _str += c; _heap(); return *this; }
+        bool operator==(const String& other) const { return _str == other._str; }
+        bool operator==(const char* other) const { return _str == other; }
+        bool operator!=(const String& other) const { return _str != other._str; }
+        bool operator!=(const char* other) const { return _str != other; }
+
+    private:
+        std::string _str;
+        void _heap() { if (!_str.empty()) _str.reserve(2 * sizeof(std::string)); }  // beyond the small string buffer of std::string
+        static std::string _format(long long value, unsigned char base) {
+            char buf[72];
+            if (base == HEX) snprintf(buf, sizeof(buf), "%llx", value);
+            else if (base == BIN) {
+                char* p = buf + sizeof(buf) - 1;
+                *p = '\0';
+                unsigned long long v = value;
+                do { *--p = '0' + (v & 1); v >>= 1; } while (v);
+                return p;
+            }
+            else snprintf(buf, sizeof(buf), "%lld", value);
+            return buf;
+        }
+        static std::string _format(double value, unsigned char decimals) {
+            char buf[48];
+            snprintf(buf, sizeof(buf), "%.*f", decimals, value);
+            return buf;
+        }
+};
+
+inline bool operator==(const char* a, const String& b) { return b == a; }
+
+/*
+Serial output is dropped unless sim::echoSerial is set
+*/
+namespace sim { extern bool echoSerial; }
+class HardwareSerial {
+    public:
+        void begin(unsigned long) {}
+        template<class T> void print(const T& value) { _out(String(value)); }
+        template<class T> void print(const T& value, int format) { _out(String(value, format)); }
+        template<class T> void println(const T& value) { print(value); println(); }
+        template<class T> void println(const T& value, int format) { print(value, format); println(); }
+        void println() { _out(String("\n")); }
+        void print(const char* str) { _out(String(str)); }
+        void println(const char* str) { print(str); println(); }
+        void print(const String& str) { _out(str); }
+        void println(const String& str) { print(str); println(); }
+
+    private:
+        void _out(const String& str) { if (sim::echoSerial) fputs(str.c_str(), stdout); }
+};
+extern HardwareSerial Serial;
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+
+template<class A, class B> auto min(A a, B b) -> decltype(a < b ? a : b) { return (b < a) ? b : a; }
+template<class A, class B> auto max(A a, B b) -> decltype(a < b ? a : b) { return (a < b) ? b : a; }
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+#define D5 14
+#define D6 12
+#define D7 13
+
+#endif // SIM_ARDUINO_H
@@ -0,0 +1,335 @@
+#include <ArduinoJson.h>
+
+namespace sim_json {
+
+Pool::Pool(size_t capacity) : _capacity(capacity) {
+    _nodeCount = capacity / JSON_SLOT_SIZE;
+    _nodes = new Node[_nodeCount + 1];
+    _strings = new char[capacity + 1];
+}
+
+Pool::~Pool() {
+    delete[] _nodes;
+    delete[] _strings;
+}
+
+/*
+Takes a slot from the pool, returns nullptr (and marks the pool overflowed) if the capacity is used up
+*/
+Node* Pool::allocNode() {
+    if (_used + JSON_SLOT_SIZE > _capacity || _nodesUsed >= _nodeCount) {
+        _overflowed = true;
+        return nullptr;
+    }
+    _used += JSON_SLOT_SIZE;
+    Node* node = &_nodes[_nodesUsed++];
+    memset(node, 0, sizeof(Node));
+    return node;
+}
+
+/*
+Copies a string into the pool, returns nullptr (and marks the pool overflowed) if the capacity is used up
+*/
+const char* Pool::copyString(const char* str) {
+    size_t len = strlen(str) + 1;
+    if (_used + len > _capacity) {
+        _overflowed = true;
+        return nullptr;
+    }
+    _used += len;
+    char* copy = _strings + _stringsUsed;
+    memcpy(copy, str, len);
+    _stringsUsed += len;
+    return copy;
+}
+
+void Pool::clear() {
+    _used = 0;
+    _overflowed = false;
+    _nodesUsed = 0;
+    _stringsUsed = 0;
+}
+
+/*
+Appends a string in JSON notation
+*/
+static void serializeString(const char* str, std::string* out) {
+    out->push_back('"');
+    for (const char* c = str; *c; ++c) {
+        if (*c == '"' || *c == '\\') out->push_back('\\');
+        out->push_back(*c);
+    }
+    out->push_back('"');
+}
+
+/*
+Appends a float the way ArduinoJson does for the magnitudes used here: up to 9 decimal places without trailing zeros
+*/
+static void serializeFloat(double value, std::string* out) {
+    if (isnan(value) || isinf(value)) {
+        out->append("null");
+        return;
+    }
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%.9f", value);
+    char* end = buf + strlen(buf);
+    while (end > buf && end[-1] == '0') --end;
+    if (end > buf && end[-1] == '.') --end;
+    *end = '\0';
+    if (strcmp(buf, "-0") == 0) strcpy(buf, "0");
+    out->append(buf);
+}
+
+void serialize(const Node* node, std::string* out) {
+    char buf[32];
+    if (node == nullptr) {
+        out->append("null");
+        return;
+    }
+    switch (node->type) {
+        case T_NULL:
+            out->append("null");
+            break;
+        case T_BOOL:
+            out->append(node->b ? "true" : "false");
+            break;
+        case T_INT:
+            snprintf(buf, sizeof(buf), "%lld", (long long)node->i);
+            out->append(buf);
+            break;
+        case T_UINT:
+            snprintf(buf, sizeof(buf), "%llu", (unsigned long long)node->u);
+            out->append(buf);
+            break;
+        case T_FLOAT:
+            serializeFloat(node->f, out);
+            break;
+        case T_STRING:
+            serializeString(node->s, out);
+            break;
+        case T_ARRAY:
+        case T_OBJECT:
+            out->push_back(node->type == T_ARRAY ? '[' : '{');
+            for (const Node* child = node->first; child != nullptr; child = child->next) {
+                if (child != node->first) out->push_back(',');
+                if (node->type == T_OBJECT) {
+                    serializeString(child->key, out);
+                    out->push_back(':');
+                }
+                serialize(child, out);
+            }
+            out->push_back(node->type == T_ARRAY ? ']' : '}');
+            break;
+    }
+}
+
+size_t measure(const Node* node) {
+    std::string out;
+    serialize(node, &out);
+    return out.size();
+}
+
+}  // namespace sim_json
+
+using namespace sim_json;
+
+Node* JsonVariant::_find(const char* key) const {
+    if (_node == nullptr || _node->type != T_OBJECT || key == nullptr) return nullptr;
+    for (Node* child = _node->first; child != nullptr; child = child->next) {
+        if (strcmp(child->key, key) == 0) return child;
+    }
+    return nullptr;
+}
+
+JsonVariant JsonVariant::_member(const char* key, bool copyKey) const {
+    Node* child = _find(key);
+    if (child != nullptr) return JsonVariant(_pool, child);
+    if (_node == nullptr || (_node->type != T_OBJECT && _node->type != T_NULL)) return JsonVariant();
+    return JsonVariant(_pool, _node, key, copyKey);
+}
+
+JsonVariant JsonVariant::operator[](const char* key) const {
+    return _member(key, false);
+}
+
+JsonVariant JsonVariant::operator[](int index) const {
+    if (_node == nullptr || _node->type != T_ARRAY || index < 0) return JsonVariant();
+    Node* child = _node->first;
+    for (int i = 0; i < index && child != nullptr; ++i) child = child->next;
+    return JsonVariant(_pool, child);
+}
+
+/*
+Adds a child to an array or object (a null parent becomes an object), returns nullptr if the pool is used up
+*/
+Node* JsonVariant::_addChild(Node* parent, const char* key, bool copyKey) const {
+    if (parent == nullptr || _pool == nullptr) return nullptr;
+    if (parent->type == T_NULL) {
+        parent->type = (key != nullptr) ? T_OBJECT : T_ARRAY;
+        parent->first = parent->last = nullptr;
+        parent->size = 0;
+    }
+    if (parent->type != ((key != nullptr) ? T_OBJECT : T_ARRAY)) return nullptr;
+    Node* node = _pool->allocNode();
+    if (node == nullptr) return nullptr;
+    if (key != nullptr && copyKey) {
+        key = _pool->copyString(key);
+        if (key == nullptr) return nullptr;
+    }
+    node->type = T_NULL;
+    node->key = key;
+    if (parent->last == nullptr) parent->first = node;
+    else parent->last->next = node;
+    parent->last = node;
+    ++parent->size;
+    return node;
+}
+
+/*
+Gets the member key of an object (adds it if missing) and turns it into an empty collection of type
+*/
+Node* JsonVariant::_replace(Node* parent, const char* key, NodeType type) const {
+    JsonVariant member = JsonVariant(_pool, parent)._member(key, false);
+    Node* node = member._resolve();
+    if (node == nullptr) return nullptr;
+    _clear(node);
+    node->type = type;
+    return node;
+}
+
+Node* JsonVariant::_resolve() {
+    if (_node == nullptr && _parent != nullptr) {
+        _node = _addChild(_parent, _key, _copyKey);
+        if (_node != nullptr) _parent = nullptr;
+    }
+    return _node;
+}
+
+void JsonVariant::_clear(Node* node) {
+    node->type = T_NULL;
+    node->first = node->last = nullptr;
+    node->size = 0;
+}
+
+bool JsonVariant::_set(const bool& value) {
+    Node* node = _resolve();
+    if (node == nullptr) return false;
+    _clear(node);
+    node->type = T_BOOL;
+    node->b = value;
+    return true;
+}
+
+bool JsonVariant::_set(const char* value) {
+    Node* node = _resolve();
+    if (node == nullptr) return false;
+    _clear(node);
+    if (value == nullptr) return true;
+    node->type = T_STRING;
+    node->s = value;
+    return true;
+}
+
+bool JsonVariant::_set(char* value) {
+    if (value == nullptr) return _set((const char*)nullptr);
+    Node* node = _resolve();
+    if (node == nullptr) return false;
+    const char* copy = _pool->copyString(value);
+    if (copy == nullptr) return false;
+    _clear(node);
+    node->type = T_STRING;
+    node->s = copy;
+    return true;
+}
+
+bool JsonVariant::_set(const String& value) {
+    return _set(const_cast<char*>(value.c_str()));
+}
+
+JsonArray JsonVariant::createNestedArray(const char* key) const {
+    return JsonArray(_pool, _replace(_node, key, T_ARRAY));
+}
+
+JsonArray JsonVariant::createNestedArray(const String& key) const {
+    JsonVariant member = _member(key.c_str(), true);
+    Node* node = member._resolve();
+    if (node == nullptr) return JsonArray();
+    _clear(node);
+    node->type = T_ARRAY;
+    return JsonArray(_pool, node);
+}
+
+JsonObject JsonVariant::createNestedObject(const char* key) const {
+    return JsonObject(_pool, _replace(_node, key, T_OBJECT));
+}
+
+JsonArray JsonArray::createNestedArray() const {
+    Node* node = _addElement();
+    if (node != nullptr) node->type = T_ARRAY;
+    return JsonArray(_pool, node);
+}
+
+JsonObject JsonArray::createNestedObject() const {
+    Node* node = _addElement();
+    if (node != nullptr) node->type = T_OBJECT;
+    return JsonObject(_pool, node);
+}
+
+void JsonArray::clear() const {
+    if (_node != nullptr && _node->type == T_ARRAY) _clear(_node);
+    if (_node != nullptr) _node->type = T_ARRAY;
+}
+
+/*
+Unlinks a member, like ArduinoJson 6 the slot is not given back to the pool
+*/
+void JsonObject::remove(const char* key) const {
+    if (_node == nullptr || _node->type != T_OBJECT) return;
+    Node* prev = nullptr;
+    for (Node* child = _node->first; child != nullptr; prev = child, child = child->next) {
+        if (strcmp(child->key, key) != 0) continue;
+        if (prev == nullptr) _node->first = child->next;
+        else prev->next = child->next;
+        if (_node->last == child) _node->last = prev;
+        --_node->size;
+        return;
+    }
+}
+
+void JsonObject::clear() const {
+    if (_node != nullptr && _node->type == T_OBJECT) {
+        _clear(_node);
+        _node->type = T_OBJECT;
+    }
+}
+
+void JsonDocument::clear() {
+    _pool.clear();
+    memset(&_rootNode, 0, sizeof(_rootNode));
+    _rootNode.type = T_NULL;
+}
+
+JsonVariant JsonDocument::_root() {
+    return JsonVariant(&_pool, &_rootNode);
+}
+
+size_t measureJson(const JsonVariant& variant) {
+    return measure(variant._node);
+}
+
+size_t serializeJson(const JsonVariant& variant, char* buffer, size_t size) {
+    std::string out;
+    serialize(variant._node, &out);
+    if (size == 0) return 0;
+    size_t len = min(out.size(), size - 1);
+    memcpy(buffer, out.data(), len);
+    buffer[len] = '\0';
+    return len;
+}
+
+size_t serializeJson(const JsonVariant& variant, String& out) {
+    std::string str;
+    serialize(variant._node, &str);
+    out = String(str);
+    return str.size();
+}
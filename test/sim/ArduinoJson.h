@@ -0,0 +1,361 @@
+#ifndef SIM_ARDUINOJSON_H
+#define SIM_ARDUINOJSON_H
+
+/*
+Host stand-in for the subset of ArduinoJson 6 used by the feature. It keeps the memory model that matters for sizing:
+every array element and object member costs one slot of JSON_SLOT_SIZE bytes (the size of a VariantSlot on ESP8266),
+const char* values and keys are linked without a copy while char* and String are copied into the document.
+A document fails to add values once it's capacity is used up (overflowed() turns true), just like ArduinoJson.
+All storage is allocated by the constructor, so adding to a document never touches the heap.
+*/
+
+#include <Arduino.h>
+#include <type_traits>
+
+#define JSON_SLOT_SIZE 16
+#define JSON_ARRAY_SIZE(n) ((n) * JSON_SLOT_SIZE)
+#define JSON_OBJECT_SIZE(n) ((n) * JSON_SLOT_SIZE)
+
+namespace sim_json {
+
+enum NodeType : uint8_t { T_NULL, T_BOOL, T_INT, T_UINT, T_FLOAT, T_STRING, T_ARRAY, T_OBJECT };
+
+struct Node {
+    NodeType type;
+    const char* key;
+    union {
+        bool b;
+        int64_t i;
+        uint64_t u;
+        double f;
+        const char* s;
+    };
+    Node* first;  // children of arrays and objects
+    Node* last;
+    Node* next;
+    size_t size;
+};
+
+class Pool {
+    public:
+        explicit Pool(size_t capacity);
+        ~Pool();
+        Pool(const Pool&) = delete;
+        Pool& operator=(const Pool&) = delete;
+        Node* allocNode();
+        const char* copyString(const char* str);
+        void clear();
+        size_t capacity() const { return _capacity; }
+        size_t memoryUsage() const { return _used; }
+        bool overflowed() const { return _overflowed; }
+
+    private:
+        size_t _capacity;
+        size_t _used = 0;
+        bool _overflowed = false;
+        Node* _nodes;
+        size_t _nodeCount;
+        size_t _nodesUsed = 0;
+        char* _strings;
+        size_t _stringsUsed = 0;
+};
+
+void serialize(const Node* node, std::string* out);
+size_t measure(const Node* node);
+
+template<class T, class Enable = void> struct Converter;  // conversions of as<T>() and is<T>(), see end of file
+
+}  // namespace sim_json
+
+class JsonArray;
+class JsonObject;
+
+/*
+Reference to a value in a document. References to a missing object member (as returned by operator[] on an object)
+remember their parent and key, the member is only added once a value is set.
+*/
+class JsonVariant {
+    public:
+        JsonVariant() {}
+        JsonVariant(sim_json::Pool* pool, sim_json::Node* node) : _pool(pool), _node(node) {}
+        JsonVariant(sim_json::Pool* pool, sim_json::Node* parent, const char* key, bool copyKey)
+            : _pool(pool), _parent(parent), _key(key), _copyKey(copyKey) {}
+
+        bool isNull() const { return _node == nullptr || _node->type == sim_json::T_NULL; }
+        size_t size() const { return (_node != nullptr && (_node->type == sim_json::T_ARRAY || _node->type == sim_json::T_OBJECT)) ? _node->size : 0; }
+        template<class T> T as() const;
+        template<class T> bool is() const;
+
+        template<class T> bool set(const T& value) { return _set(value); }
+        bool set(const char* value) { return _set(value); }
+        bool set(char* value) { return _set(value); }
+        template<class T> JsonVariant& operator=(const T& value) { _set(value); return *this; }
+        JsonVariant& operator=(const char* value) { _set(value); return *this; }
+        JsonVariant& operator=(char* value) { _set(value); return *this; }
+
+        JsonVariant operator[](const char* key) const;
+        JsonVariant operator[](char* key) const { return _member(key, true); }
+        JsonVariant operator[](const String& key) const { return _member(key.c_str(), true); }
+        JsonVariant operator[](int index) const;
+        bool containsKey(const char* key) const { return _find(key) != nullptr; }
+        bool containsKey(const String& key) const { return _find(key.c_str()) != nullptr; }
+
+        JsonArray createNestedArray(const char* key) const;
+        JsonArray createNestedArray(const String& key) const;
+        JsonObject createNestedObject(const char* key) const;
+
+    protected:
+        sim_json::Pool* _pool = nullptr;
+        sim_json::Node* _node = nullptr;
+        sim_json::Node* _parent = nullptr;  // pending object member
+        const char* _key = nullptr;
+        bool _copyKey = false;
+
+        sim_json::Node* _find(const char* key) const;
+        JsonVariant _member(const char* key, bool copyKey) const;
+        sim_json::Node* _resolve();  // adds a pending member
+        sim_json::Node* _addChild(sim_json::Node* parent, const char* key, bool copyKey) const;
+        sim_json::Node* _replace(sim_json::Node* parent, const char* key, sim_json::NodeType type) const;
+
+        template<class T>
+        typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value, bool>::type _set(const T& value) {
+            sim_json::Node* node = _resolve();
+            if (node == nullptr) return false;
+            _clear(node);
+            if (std::is_signed<T>::value && value < 0) {
+                node->type = sim_json::T_INT;
+                node->i = value;
+            }
+            else {
+                node->type = sim_json::T_UINT;
+                node->u = value;
+            }
+            return true;
+        }
+        template<class T>
+        typename std::enable_if<std::is_floating_point<T>::value, bool>::type _set(const T& value) {
+            sim_json::Node* node = _resolve();
+            if (node == nullptr) return false;
+            _clear(node);
+            node->type = sim_json::T_FLOAT;
+            node->f = value;
+            return true;
+        }
+        bool _set(const bool& value);
+        bool _set(const char* value);  // linked
+        bool _set(char* value);  // copied
+        bool _set(const String& value);  // copied
+        static void _clear(sim_json::Node* node);
+
+        friend class JsonArray;
+        friend class JsonObject;
+        friend class JsonDocument;
+        friend class JsonPair;
+        friend class JsonArrayIterator;
+        friend size_t measureJson(const JsonVariant& variant);
+        friend size_t serializeJson(const JsonVariant& variant, char* buffer, size_t size);
+        friend size_t serializeJson(const JsonVariant& variant, String& out);
+};
+
+class JsonArrayIterator {
+    public:
+        JsonArrayIterator(sim_json::Pool* pool, sim_json::Node* node) : _pool(pool), _node(node) {}
+        JsonVariant operator*() const { return JsonVariant(_pool, _node); }
+        JsonArrayIterator& operator++() { _node = _node->next; return *this; }
+        bool operator!=(const JsonArrayIterator& other) const { return _node != other._node; }
+
+    private:
+        sim_json::Pool* _pool;
+        sim_json::Node* _node;
+};
+
+class JsonArray : public JsonVariant {
+    public:
+        JsonArray() {}
+        JsonArray(sim_json::Pool* pool, sim_json::Node* node) : JsonVariant(pool, node) {}
+
+        template<class T> bool add(const T& value) const {
+            JsonVariant element(_pool, _addElement());
+            return element._node != nullptr && element.set(value);
+        }
+        bool add(const char* value) const {
+            JsonVariant element(_pool, _addElement());
+            return element._node != nullptr && element.set(value);
+        }
+        bool add(char* value) const {
+            JsonVariant element(_pool, _addElement());
+            return element._node != nullptr && element.set(value);
+        }
+        JsonVariant add() const { return JsonVariant(_pool, _addElement()); }  // null
+        JsonArray createNestedArray() const;
+        JsonObject createNestedObject() const;
+        void clear() const;
+        JsonArrayIterator begin() const { return JsonArrayIterator(_pool, _node != nullptr ? _node->first : nullptr); }
+        JsonArrayIterator end() const { return JsonArrayIterator(_pool, nullptr); }
+
+    private:
+        sim_json::Node* _addElement() const { return _addChild(_node, nullptr, false); }
+};
+
+class JsonString {
+    public:
+        JsonString(const char* str) : _str(str) {}
+        const char* c_str() const { return _str; }
+
+    private:
+        const char* _str;
+};
+
+class JsonPair {
+    public:
+        JsonPair(sim_json::Pool* pool, sim_json::Node* node) : _pool(pool), _node(node) {}
+        JsonString key() const { return JsonString(_node->key); }
+        JsonVariant value() const { return JsonVariant(_pool, _node); }
+
+    private:
+        sim_json::Pool* _pool;
+        sim_json::Node* _node;
+};
+
+class JsonObjectIterator {
+    public:
+        JsonObjectIterator(sim_json::Pool* pool, sim_json::Node* node) : _pool(pool), _node(node) {}
+        JsonPair operator*() const { return JsonPair(_pool, _node); }
+        JsonObjectIterator& operator++() { _node = _node->next; return *this; }
+        bool operator!=(const JsonObjectIterator& other) const { return _node != other._node; }
+
+    private:
+        sim_json::Pool* _pool;
+        sim_json::Node* _node;
+};
+
+class JsonObject : public JsonVariant {
+    public:
+        JsonObject() {}
+        JsonObject(sim_json::Pool* pool, sim_json::Node* node) : JsonVariant(pool, node) {}
+
+        void remove(const char* key) const;
+        void remove(const String& key) const { remove(key.c_str()); }
+        void clear() const;
+        JsonObjectIterator begin() const { return JsonObjectIterator(_pool, _node != nullptr ? _node->first : nullptr); }
+        JsonObjectIterator end() const { return JsonObjectIterator(_pool, nullptr); }
+};
+
+class JsonDocument {
+    public:
+        explicit JsonDocument(size_t capacity) : _pool(capacity) { clear(); }
+        JsonDocument(const JsonDocument&) = delete;
+        JsonDocument& operator=(const JsonDocument&) = delete;
+
+        bool isNull() const { return JsonVariant(*this).isNull(); }
+        size_t capacity() const { return _pool.capacity(); }
+        size_t memoryUsage() const { return _pool.memoryUsage(); }
+        bool overflowed() const { return _pool.overflowed(); }
+        void clear();
+
+        JsonVariant operator[](const char* key) { return _root()[key]; }
+        JsonVariant operator[](char* key) { return _root()[key]; }
+        JsonVariant operator[](const String& key) { return _root()[key]; }
+        bool containsKey(const char* key) const { return JsonVariant(const_cast<sim_json::Pool*>(&_pool), const_cast<sim_json::Node*>(&_rootNode)).containsKey(key); }
+        JsonArray createNestedArray(const char* key) { return _root().createNestedArray(key); }
+        JsonObject createNestedObject(const char* key) { return _root().createNestedObject(key); }
+        void remove(const char* key) { _root().as<JsonObject>().remove(key); }
+        template<class T> T as() { return _root().as<T>(); }
+        operator JsonVariant() const { return JsonVariant(const_cast<sim_json::Pool*>(&_pool), const_cast<sim_json::Node*>(&_rootNode)); }
+
+    private:
+        sim_json::Pool _pool;
+        sim_json::Node _rootNode;  // the root costs no slot, as in ArduinoJson
+        JsonVariant _root();
+};
+
+class DynamicJsonDocument : public JsonDocument {
+    public:
+        explicit DynamicJsonDocument(size_t capacity) : JsonDocument(capacity) {}
+};
+
+template<size_t N>
+class StaticJsonDocument : public JsonDocument {
+    public:
+        StaticJsonDocument() : JsonDocument(N) {}
+};
+
+size_t measureJson(const JsonVariant& variant);
+size_t serializeJson(const JsonVariant& variant, char* buffer, size_t size);
+size_t serializeJson(const JsonVariant& variant, String& out);
+
+// conversions of as<T>() and is<T>()
+
+namespace sim_json {
+
+template<class T>
+struct Converter<T, typename std::enable_if<std::is_arithmetic<T>::value && !std::is_same<T, bool>::value>::type> {
+    static T get(Pool*, const Node* node) {
+        if (node == nullptr) return 0;
+        switch (node->type) {
+            case T_BOOL: return node->b;
+            case T_INT: return (T)node->i;
+            case T_UINT: return (T)node->u;
+            case T_FLOAT: return (T)node->f;
+            default: return 0;
+        }
+    }
+    static bool is(const Node* node) { return node != nullptr && (node->type == T_INT || node->type == T_UINT || node->type == T_FLOAT); }
+};
+
+template<>
+struct Converter<bool> {
+    static bool get(Pool*, const Node* node) {
+        if (node == nullptr) return false;
+        switch (node->type) {
+            case T_BOOL: return node->b;
+            case T_INT: return node->i != 0;
+            case T_UINT: return node->u != 0;
+            case T_FLOAT: return node->f != 0;
+            default: return false;
+        }
+    }
+    static bool is(const Node* node) { return node != nullptr && node->type == T_BOOL; }
+};
+
+template<>
+struct Converter<const char*> {
+    static const char* get(Pool*, const Node* node) { return (node != nullptr && node->type == T_STRING) ? node->s : nullptr; }
+    static bool is(const Node* node) { return node != nullptr && node->type == T_STRING; }
+};
+
+template<>
+struct Converter<String> {
+    static String get(Pool*, const Node* node) {
+        if (node != nullptr && node->type == T_STRING) return String(node->s);
+        std::string out;
+        serialize(node, &out);
+        return String(out);
+    }
+    static bool is(const Node* node) { return node != nullptr && node->type == T_STRING; }
+};
+
+template<>
+struct Converter<JsonArray> {
+    static JsonArray get(Pool* pool, Node* node) { return JsonArray(pool, (node != nullptr && node->type == T_ARRAY) ? node : nullptr); }
+    static bool is(const Node* node) { return node != nullptr && node->type == T_ARRAY; }
+};
+
+template<>
+struct Converter<JsonObject> {
+    static JsonObject get(Pool* pool, Node* node) { return JsonObject(pool, (node != nullptr && node->type == T_OBJECT) ? node : nullptr); }
+    static bool is(const Node* node) { return node != nullptr && node->type == T_OBJECT; }
+};
+
+template<>
+struct Converter<JsonVariant> {
+    static JsonVariant get(Pool* pool, Node* node) { return JsonVariant(pool, node); }
+    static bool is(const Node*) { return true; }
+};
+
+}  // namespace sim_json
+
+template<class T> T JsonVariant::as() const { return sim_json::Converter<T>::get(_pool, _node); }
+template<class T> bool JsonVariant::is() const { return sim_json::Converter<T>::is(_node); }
+
+#endif // SIM_ARDUINOJSON_H
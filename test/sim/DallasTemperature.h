@@ -0,0 +1,59 @@
+#ifndef SIM_DALLASTEMPERATURE_H
+#define SIM_DALLASTEMPERATURE_H
+
+// Host stand-in for DallasTemperature 3.9, implemented on the OneWire stand-in like the original
+
+#include <OneWire.h>
+
+#define DEVICE_DISCONNECTED_C -127
+#define DEVICE_DISCONNECTED_RAW -7040
+#define DS18S20MODEL 0x10
+#define DS18B20MODEL 0x28
+#define DS1822MODEL 0x22
+#define DS1825MODEL 0x3B
+#define DS28EA00MODEL 0x42
+
+typedef uint8_t DeviceAddress[8];
+typedef uint8_t ScratchPad[9];
+
+class DallasTemperature {
+    public:
+        DallasTemperature() {}
+        explicit DallasTemperature(OneWire* wire) : _wire(wire) {}
+        void setOneWire(OneWire* wire) { _wire = wire; }
+        void begin();
+        uint8_t getDeviceCount() { return _devices; }
+        bool validAddress(const uint8_t* deviceAddress) { return _wire->crc8(deviceAddress, 7) == deviceAddress[7]; }
+        bool validFamily(const uint8_t* deviceAddress);
+        bool getAddress(uint8_t* deviceAddress, uint8_t index);
+        bool isConnected(const uint8_t* deviceAddress);
+        bool isConnected(const uint8_t* deviceAddress, uint8_t* scratchPad);
+        bool readScratchPad(const uint8_t* deviceAddress, uint8_t* scratchPad);
+        void writeScratchPad(const uint8_t* deviceAddress, const uint8_t* scratchPad);
+        bool readPowerSupply(const uint8_t* deviceAddress = nullptr);
+        uint8_t getResolution(const uint8_t* deviceAddress);
+        void setResolution(uint8_t newResolution);
+        bool setResolution(const uint8_t* deviceAddress, uint8_t newResolution, bool skipGlobalBitResolutionCalculation = false);
+        void setWaitForConversion(bool flag) { _waitForConversion = flag; }
+        void requestTemperatures();
+        bool requestTemperaturesByAddress(const uint8_t* deviceAddress);
+        int16_t millisToWaitForConversion(uint8_t bitResolution);
+        bool isConversionComplete() { return _wire->read_bit() == 1; }
+        int16_t getTemp(const uint8_t* deviceAddress);
+        float getTempC(const uint8_t* deviceAddress);
+        void setHighAlarmTemp(const uint8_t* deviceAddress, int8_t celsius);
+        void setLowAlarmTemp(const uint8_t* deviceAddress, int8_t celsius);
+        bool alarmSearch(uint8_t* newAddr) { return _wire->alarmSearch(newAddr); }
+        void resetAlarmSearch() { _wire->resetAlarmSearch(); }
+
+    private:
+        OneWire* _wire = nullptr;
+        uint8_t _devices = 0;
+        bool _parasite = false;
+        uint8_t _bitResolution = 9;
+        bool _waitForConversion = true;
+
+        void _blockTillConversionComplete(uint8_t bitResolution);
+};
+
+#endif // SIM_DALLASTEMPERATURE_H
@@ -0,0 +1,479 @@
+#include <OneWire.h>
+#include <DallasTemperature.h>
+
+static bool _isS20(const sim::DS18B20& dev) {
+    return dev.rom[0] == 0x10;
+}
+
+/*
+Resolution (9 to 12 bit) of a DS18B20 as set in the configuration register of it's scratchpad,
+a DS18S20 has none and converts as long as a DS18B20 with 12 bit
+*/
+static uint8_t _resolution(const sim::DS18B20& dev) {
+    if (_isS20(dev)) return 12;
+    return ((dev.scratchpad[4] >> 5) & 0x03) + 9;
+}
+
+static uint64_t _conversionUs(uint8_t resolution) {
+    return 93750ull << (resolution - 9);
+}
+
+/*
+Search order of the OneWire search algorithm: ROM bits are compared starting with the LSB of the family code
+*/
+static uint64_t _searchKey(const uint8_t rom[8]) {
+    uint64_t key = 0;
+    for (uint8_t i = 0; i < 64; ++i) {
+        if (rom[i / 8] & (1 << (i % 8))) key |= 1ull << (63 - i);
+    }
+    return key;
+}
+
+/*
+Alarm flag as set by the last conversion (integer part of the temperature compared against TH and TL)
+*/
+static bool _alarmed(const sim::DS18B20& dev) {
+    int16_t raw = dev.scratchpad[0] | (dev.scratchpad[1] << 8);
+    int8_t t = _isS20(dev) ? raw >> 1 : raw >> 4;
+    return t >= (int8_t)dev.scratchpad[2] || t <= (int8_t)dev.scratchpad[3];
+}
+
+void OneWire::begin(uint8_t pin) {
+    _bus = sim::bus(pin);
+    _state = IDLE;
+}
+
+void OneWire::_spend(uint64_t us, bool bits) {
+    sim::advance(us);
+    sim::stats.oneWireUs += us;
+    if (bits) sim::stats.slots += us / sim::OW_SLOT_US;
+}
+
+void OneWire::_settle() {
+    for (uint8_t i = 0; i < _bus->count; ++i) {
+        sim::DS18B20& dev = _bus->devices[i];
+        if (!dev.converting || sim::clockUs < dev.convDoneAt) continue;
+        dev.converting = false;
+        if (dev.stuck || (dev.parasite && !dev.convPowered)) continue;
+        int16_t raw = (int16_t)lroundf(dev.temp * 16);
+        if (_isS20(dev)) {  // whole degrees - 0.25 + (16 - COUNT_REMAIN) / 16, the 0.5 degree bit is rounded
+            int16_t whole = (int16_t)floorf((raw + 4) / 16.0f) * 16;
+            dev.scratchpad[6] = 12 - (raw - whole);
+            raw = whole / 8 + ((raw - whole >= 4) ? 1 : 0);
+        }
+        else raw &= ~((1 << (12 - _resolution(dev))) - 1);
+        dev.scratchpad[0] = raw & 0xFF;
+        dev.scratchpad[1] = (raw >> 8) & 0xFF;
+        dev.scratchpad[8] = sim::crc8(dev.scratchpad, 8);
+    }
+}
+
+uint8_t OneWire::reset() {
+    _settle();
+    for (uint8_t i = 0; i < _bus->count; ++i) {  // reset ends the strong pull-up, parasite powered conversions fail
+        sim::DS18B20& dev = _bus->devices[i];
+        if (dev.converting && dev.parasite) dev.converting = false;
+    }
+    _spend(sim::OW_RESET_US);
+    sim::stats.resets++;
+    _selected = 0;
+    bool presence = false;
+    for (uint8_t i = 0; i < _bus->count; ++i) presence |= _bus->devices[i].present;
+    _state = presence ? ROM : IDLE;
+    return presence;
+}
+
+void OneWire::select(const uint8_t rom[8]) {
+    _spend(9 * sim::OW_BYTE_US);
+    sim::stats.bytesWritten += 9;
+    _selected = 0;
+    for (uint8_t i = 0; i < _bus->count; ++i) {
+        if (_bus->devices[i].present && memcmp(_bus->devices[i].rom, rom, 8) == 0) _selected |= 1ull << i;
+    }
+    _state = FUNCTION;
+}
+
+void OneWire::skip() {
+    _spend(sim::OW_BYTE_US);
+    sim::stats.bytesWritten++;
+    _selected = 0;
+    for (uint8_t i = 0; i < _bus->count; ++i) {
+        if (_bus->devices[i].present) _selected |= 1ull << i;
+    }
+    _state = FUNCTION;
+}
+
+void OneWire::write(uint8_t v, uint8_t power) {
+    _settle();
+    _spend(sim::OW_BYTE_US);
+    sim::stats.bytesWritten++;
+    if (_state == WRITE_SCRATCHPAD) {
+        for (uint8_t i = 0; i < _bus->count; ++i) {
+            if (!(_selected & (1ull << i))) continue;
+            sim::DS18B20& dev = _bus->devices[i];
+            if (_pos == 2 && _isS20(dev)) continue;  // takes TH and TL only
+            dev.scratchpad[2 + _pos] = (_pos == 2) ? ((v & 0x60) | 0x1F) : v;
+            dev.scratchpad[8] = sim::crc8(dev.scratchpad, 8);
+        }
+        if (++_pos == 3) _state = IDLE;
+        return;
+    }
+    if (_state != FUNCTION) return;
+    _state = IDLE;
+    _pos = 0;
+    switch (v) {
+        case 0x44:  // Convert T
+            sim::stats.convertTs++;
+            for (uint8_t i = 0; i < _bus->count; ++i) {
+                if (!(_selected & (1ull << i))) continue;
+                sim::DS18B20& dev = _bus->devices[i];
+                dev.converting = true;
+                dev.convPowered = power || !dev.parasite;
+                dev.convDoneAt = sim::clockUs + _conversionUs(_resolution(dev));
+            }
+            _state = CONVERTING;
+            break;
+        case 0x4E:  // Write Scratchpad
+            sim::stats.scratchpadWrites++;
+            _state = WRITE_SCRATCHPAD;
+            break;
+        case 0x48:  // Copy Scratchpad
+            sim::stats.eepromCopies++;
+            for (uint8_t i = 0; i < _bus->count; ++i) {
+                if (_selected & (1ull << i)) memcpy(_bus->devices[i].eeprom, _bus->devices[i].scratchpad + 2, _isS20(_bus->devices[i]) ? 2 : 3);
+            }
+            break;
+        case 0xBE:  // Read Scratchpad
+            sim::stats.scratchpadReads++;
+            _state = READ_SCRATCHPAD;
+            break;
+        case 0xB4:  // Read Power Supply
+            _state = POWER_SUPPLY;
+            break;
+        case 0xB8:  // Recall E2
+            for (uint8_t i = 0; i < _bus->count; ++i) {
+                if (!(_selected & (1ull << i))) continue;
+                sim::DS18B20& dev = _bus->devices[i];
+                memcpy(dev.scratchpad + 2, dev.eeprom, _isS20(dev) ? 2 : 3);
+                dev.scratchpad[8] = sim::crc8(dev.scratchpad, 8);
+            }
+            break;
+    }
+}
+
+void OneWire::write_bytes(const uint8_t* buf, uint16_t count, bool power) {
+    for (uint16_t i = 0; i < count; ++i) write(buf[i], power);
+}
+
+uint8_t OneWire::read() {
+    _settle();
+    _spend(sim::OW_BYTE_US);
+    sim::stats.bytesRead++;
+    if (_state != READ_SCRATCHPAD || _pos >= 9) return 0xFF;
+    uint8_t value = 0xFF;  // open drain: devices answering at once pull down each others bits
+    for (uint8_t i = 0; i < _bus->count; ++i) {
+        if (!(_selected & (1ull << i))) continue;
+        const sim::DS18B20& dev = _bus->devices[i];
+        uint8_t b = dev.scratchpad[_pos];
+        if (dev.corrupt && _pos == 0) b ^= 0x01;
+        value &= b;
+    }
+    _pos++;
+    return value;
+}
+
+void OneWire::read_bytes(uint8_t* buf, uint16_t count) {
+    for (uint16_t i = 0; i < count; ++i) buf[i] = read();
+}
+
+void OneWire::write_bit(uint8_t) {
+    _spend(sim::OW_SLOT_US, true);
+}
+
+uint8_t OneWire::read_bit() {
+    _settle();
+    _spend(sim::OW_SLOT_US, true);
+    if (_state == POWER_SUPPLY) {
+        for (uint8_t i = 0; i < _bus->count; ++i) {
+            if ((_selected & (1ull << i)) && _bus->devices[i].parasite) return 0;
+        }
+        return 1;
+    }
+    for (uint8_t i = 0; i < _bus->count; ++i) {  // devices hold the bus low while converting
+        if (_bus->devices[i].converting) return 0;
+    }
+    return 1;
+}
+
+void OneWire::depower() {
+    _settle();
+    for (uint8_t i = 0; i < _bus->count; ++i) {
+        sim::DS18B20& dev = _bus->devices[i];
+        if (dev.converting && dev.parasite) dev.converting = false;
+    }
+}
+
+void OneWire::reset_search() {
+    _searchStarted = false;
+    _searchDone = false;
+    _lastFound = 0;
+}
+
+void OneWire::target_search(uint8_t) {
+    reset_search();
+}
+
+bool OneWire::search(uint8_t* newAddr, bool) {
+    return _nextDevice(&_lastFound, &_searchStarted, &_searchDone, false, newAddr);
+}
+
+bool OneWire::alarmSearch(uint8_t* newAddr) {
+    return _nextDevice(&_lastAlarm, &_alarmStarted, &_alarmDone, true, newAddr);
+}
+
+void OneWire::resetAlarmSearch() {
+    _alarmStarted = false;
+    _alarmDone = false;
+    _lastAlarm = 0;
+}
+
+/*
+One pass of the search algorithm: a reset, the search command and 64 triplets of bit slots.
+After the last device was found the next call returns false without touching the bus
+*/
+bool OneWire::_nextDevice(uint64_t* last, bool* started, bool* done, bool alarmOnly, uint8_t* newAddr) {
+    if (*done) return false;
+    if (!reset()) {
+        *done = true;
+        return false;
+    }
+    _spend(sim::OW_BYTE_US);
+    sim::stats.bytesWritten++;
+    int16_t found = -1;
+    uint64_t foundKey = 0;
+    for (uint8_t i = 0; i < _bus->count; ++i) {
+        const sim::DS18B20& dev = _bus->devices[i];
+        if (!dev.present || (alarmOnly && !_alarmed(dev))) continue;
+        uint64_t key = _searchKey(dev.rom);
+        if (*started && key <= *last) continue;
+        if (found < 0 || key < foundKey) {
+            found = i;
+            foundKey = key;
+        }
+    }
+    _spend(64 * 3 * sim::OW_SLOT_US, true);
+    _state = IDLE;
+    if (found < 0) {
+        *done = true;
+        return false;
+    }
+    memcpy(newAddr, _bus->devices[found].rom, 8);
+    sim::stats.searches++;
+    *last = foundKey;
+    *started = true;
+    // the last device of the search sets the last device flag, next call returns false right away
+    bool more = false;
+    for (uint8_t i = 0; i < _bus->count; ++i) {
+        const sim::DS18B20& dev = _bus->devices[i];
+        if (dev.present && (!alarmOnly || _alarmed(dev)) && _searchKey(dev.rom) > foundKey) more = true;
+    }
+    *done = !more;
+    return true;
+}
+
+//------------------------------------------
+// DallasTemperature, implemented like version 3.9
+void DallasTemperature::begin() {
+    DeviceAddress deviceAddress;
+    _wire->reset_search();
+    _devices = 0;
+    while (_wire->search(deviceAddress)) {
+        if (!validAddress(deviceAddress)) continue;
+        _devices++;
+        if (!validFamily(deviceAddress)) continue;
+        if (!_parasite && readPowerSupply(deviceAddress)) _parasite = true;
+        uint8_t b = getResolution(deviceAddress);
+        if (b > _bitResolution) _bitResolution = b;
+    }
+}
+
+bool DallasTemperature::validFamily(const uint8_t* deviceAddress) {
+    switch (deviceAddress[0]) {
+        case DS18S20MODEL:
+        case DS18B20MODEL:
+        case DS1822MODEL:
+        case DS1825MODEL:
+        case DS28EA00MODEL:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool DallasTemperature::getAddress(uint8_t* deviceAddress, uint8_t index) {
+    uint8_t depth = 0;
+    _wire->reset_search();
+    while (depth <= index && _wire->search(deviceAddress)) {
+        if (depth == index && validAddress(deviceAddress)) return true;
+        depth++;
+    }
+    return false;
+}
+
+bool DallasTemperature::isConnected(const uint8_t* deviceAddress) {
+    ScratchPad scratchPad;
+    return isConnected(deviceAddress, scratchPad);
+}
+
+bool DallasTemperature::isConnected(const uint8_t* deviceAddress, uint8_t* scratchPad) {
+    bool b = readScratchPad(deviceAddress, scratchPad);
+    return b && (OneWire::crc8(scratchPad, 8) == scratchPad[8]);
+}
+
+bool DallasTemperature::readScratchPad(const uint8_t* deviceAddress, uint8_t* scratchPad) {
+    int b = _wire->reset();
+    if (b == 0) return false;
+    _wire->select(deviceAddress);
+    _wire->write(0xBE);
+    for (uint8_t i = 0; i < 9; i++) scratchPad[i] = _wire->read();
+    b = _wire->reset();
+    return (b == 1);
+}
+
+void DallasTemperature::writeScratchPad(const uint8_t* deviceAddress, const uint8_t* scratchPad) {
+    _wire->reset();
+    _wire->select(deviceAddress);
+    _wire->write(0x4E);
+    _wire->write(scratchPad[2]);
+    _wire->write(scratchPad[3]);
+    if (deviceAddress[0] != DS18S20MODEL) _wire->write(scratchPad[4]);
+    _wire->reset();
+    _wire->select(deviceAddress);  // 3.9 saves the written values to EEPROM right away
+    _wire->write(0x48, _parasite);
+    delay(20);
+    if (_parasite) delay(10);
+    _wire->reset();
+}
+
+bool DallasTemperature::readPowerSupply(const uint8_t* deviceAddress) {
+    bool parasiteMode = false;
+    _wire->reset();
+    if (deviceAddress == nullptr) _wire->skip();
+    else _wire->select(deviceAddress);
+    _wire->write(0xB4);
+    if (_wire->read_bit() == 0) parasiteMode = true;
+    _wire->reset();
+    return parasiteMode;
+}
+
+uint8_t DallasTemperature::getResolution(const uint8_t* deviceAddress) {
+    if (deviceAddress[0] == DS18S20MODEL) return 12;
+    ScratchPad scratchPad;
+    if (!isConnected(deviceAddress, scratchPad)) return 0;
+    return ((scratchPad[4] >> 5) & 0x03) + 9;
+}
+
+void DallasTemperature::setResolution(uint8_t newResolution) {
+    _bitResolution = constrain(newResolution, 9, 12);
+    DeviceAddress deviceAddress;
+    for (uint8_t i = 0; i < _devices; i++) {
+        if (getAddress(deviceAddress, i)) setResolution(deviceAddress, _bitResolution, true);
+    }
+}
+
+bool DallasTemperature::setResolution(const uint8_t* deviceAddress, uint8_t newResolution, bool skipGlobalBitResolutionCalculation) {
+    bool success = false;
+    if (deviceAddress[0] == DS18S20MODEL) success = true;  // no configuration register
+    else {
+        newResolution = constrain(newResolution, 9, 12);
+        uint8_t newValue = ((newResolution - 9) << 5) | 0x1F;
+        ScratchPad scratchPad;
+        if (isConnected(deviceAddress, scratchPad)) {
+            if (scratchPad[4] != newValue) {
+                scratchPad[4] = newValue;
+                writeScratchPad(deviceAddress, scratchPad);
+            }
+            success = true;
+        }
+    }
+    if (!skipGlobalBitResolutionCalculation) {
+        _bitResolution = newResolution;
+        if (_devices > 1) {
+            DeviceAddress address;
+            for (uint8_t i = 0; i < _devices; i++) {
+                if (_bitResolution == 12) break;
+                if (getAddress(address, i)) {
+                    uint8_t b = getResolution(address);
+                    if (b > _bitResolution) _bitResolution = b;
+                }
+            }
+        }
+    }
+    return success;
+}
+
+void DallasTemperature::requestTemperatures() {
+    _wire->reset();
+    _wire->skip();
+    _wire->write(0x44, _parasite);
+    if (!_waitForConversion) return;
+    _blockTillConversionComplete(_bitResolution);
+}
+
+bool DallasTemperature::requestTemperaturesByAddress(const uint8_t* deviceAddress) {
+    uint8_t bitResolution = getResolution(deviceAddress);
+    if (bitResolution == 0) return false;
+    _wire->reset();
+    _wire->select(deviceAddress);
+    _wire->write(0x44, _parasite);
+    if (!_waitForConversion) return true;
+    _blockTillConversionComplete(bitResolution);
+    return true;
+}
+
+void DallasTemperature::_blockTillConversionComplete(uint8_t bitResolution) {
+    if (!_parasite) {
+        unsigned long start = millis();
+        while (!isConversionComplete() && (millis() - start < 750)) yield();
+    }
+    else delay(millisToWaitForConversion(bitResolution));
+}
+
+int16_t DallasTemperature::millisToWaitForConversion(uint8_t bitResolution) {
+    switch (bitResolution) {
+        case 9: return 94;
+        case 10: return 188;
+        case 11: return 375;
+        default: return 750;
+    }
+}
+
+int16_t DallasTemperature::getTemp(const uint8_t* deviceAddress) {
+    ScratchPad scratchPad;
+    if (!isConnected(deviceAddress, scratchPad)) return DEVICE_DISCONNECTED_RAW;
+    int16_t raw = (((int16_t)scratchPad[1]) << 11) | (((int16_t)scratchPad[0]) << 3);
+    if (deviceAddress[0] == DS18S20MODEL) raw = ((raw & 0xFFF0) << 3) - 32 + (((scratchPad[7] - scratchPad[6]) << 7) / scratchPad[7]);
+    return raw;
+}
+
+float DallasTemperature::getTempC(const uint8_t* deviceAddress) {
+    int16_t raw = getTemp(deviceAddress);
+    if (raw <= DEVICE_DISCONNECTED_RAW) return DEVICE_DISCONNECTED_C;
+    return raw * 0.0078125f;
+}
+
+void DallasTemperature::setHighAlarmTemp(const uint8_t* deviceAddress, int8_t celsius) {
+    celsius = constrain(celsius, -55, 125);
+    ScratchPad scratchPad;
+    if (!isConnected(deviceAddress, scratchPad)) return;
+    scratchPad[2] = (uint8_t)celsius;
+    writeScratchPad(deviceAddress, scratchPad);
+}
+
+void DallasTemperature::setLowAlarmTemp(const uint8_t* deviceAddress, int8_t celsius) {
+    celsius = constrain(celsius, -55, 125);
+    ScratchPad scratchPad;
+    if (!isConnected(deviceAddress, scratchPad)) return;
+    scratchPad[3] = (uint8_t)celsius;
+    writeScratchPad(deviceAddress, scratchPad);
+}
@@ -0,0 +1,49 @@
+#ifndef SIM_ONEWIRE_H
+#define SIM_ONEWIRE_H
+
+// Host stand-in for OneWire, talks to the simulated DS18B20 sensors of the bus on it's pin (see sim.h)
+
+#include <Arduino.h>
+#include "sim.h"
+
+class OneWire {
+    public:
+        OneWire() {}
+        explicit OneWire(uint8_t pin) { begin(pin); }
+        void begin(uint8_t pin);
+        uint8_t reset();
+        void select(const uint8_t rom[8]);
+        void skip();
+        void write(uint8_t v, uint8_t power = 0);
+        void write_bytes(const uint8_t* buf, uint16_t count, bool power = 0);
+        uint8_t read();
+        void read_bytes(uint8_t* buf, uint16_t count);
+        void write_bit(uint8_t v);
+        uint8_t read_bit();
+        void depower();
+        void reset_search();
+        void target_search(uint8_t family_code);
+        bool search(uint8_t* newAddr, bool search_mode = true);
+        bool alarmSearch(uint8_t* newAddr);  // used by the DallasTemperature stand-in
+        void resetAlarmSearch();
+        static uint8_t crc8(const uint8_t* addr, uint8_t len) { return sim::crc8(addr, len); }
+
+    private:
+        enum State : uint8_t { IDLE, ROM, FUNCTION, WRITE_SCRATCHPAD, READ_SCRATCHPAD, CONVERTING, POWER_SUPPLY };
+        sim::OneWireBus* _bus = nullptr;
+        State _state = IDLE;
+        uint64_t _selected = 0;  // bitmask of selected device indexes
+        uint8_t _pos = 0;  // byte position within read or write of scratchpad
+        uint64_t _lastFound = 0;  // search key of the last device found
+        bool _searchDone = false;
+        bool _searchStarted = false;
+        uint64_t _lastAlarm = 0;
+        bool _alarmDone = false;
+        bool _alarmStarted = false;
+
+        void _spend(uint64_t us, bool bits = false);
+        void _settle();  // finishes conversions that are due
+        bool _nextDevice(uint64_t* last, bool* started, bool* done, bool alarmOnly, uint8_t* newAddr);
+};
+
+#endif // SIM_ONEWIRE_H
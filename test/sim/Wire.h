@@ -0,0 +1,30 @@
+#ifndef SIM_WIRE_H
+#define SIM_WIRE_H
+
+// Host stand-in for the Arduino Wire library, talks to the simulated HDC1080 and SHT4x (see sim.h)
+
+#include <Arduino.h>
+
+class TwoWire {
+    public:
+        void begin() {}
+        void beginTransmission(uint8_t address);
+        size_t write(uint8_t data);
+        uint8_t endTransmission(bool sendStop = true);
+        uint8_t requestFrom(uint8_t address, uint8_t quantity);
+        int available() { return _rxLen - _rxPos; }
+        int read() { return (_rxPos < _rxLen) ? _rx[_rxPos++] : -1; }
+
+    private:
+        static const uint8_t BUFFER_SIZE = 32;
+        uint8_t _address = 0;
+        uint8_t _tx[BUFFER_SIZE];
+        uint8_t _txLen = 0;
+        uint8_t _rx[BUFFER_SIZE];
+        uint8_t _rxLen = 0;
+        uint8_t _rxPos = 0;
+};
+
+extern TwoWire Wire;
+
+#endif // SIM_WIRE_H
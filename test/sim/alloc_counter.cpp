@@ -0,0 +1,41 @@
+/*
+Counts heap allocations of the whole program in sim::allocations (glibc only).
+operator new of libstdc++ allocates with malloc, so it is covered as well
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void __libc_free(void* ptr);
+}
+
+namespace sim {
+uint64_t allocations = 0;
+}
+
+extern "C" {
+
+void* malloc(size_t size) {
+    sim::allocations++;
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+    sim::allocations++;
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size) {
+    sim::allocations++;
+    return __libc_realloc(ptr, size);
+}
+
+void free(void* ptr) {
+    __libc_free(ptr);
+}
+
+}
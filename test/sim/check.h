@@ -0,0 +1,25 @@
+#ifndef SIM_CHECK_H
+#define SIM_CHECK_H
+
+// Minimal assertions for the host tests, main() returns checkResult()
+
+#include <stdio.h>
+
+static int checkFailures = 0;
+
+#define CHECK(cond, ...) do { \
+    if (!(cond)) { \
+        ++checkFailures; \
+        fprintf(stderr, "%s:%d: CHECK(%s) failed: ", __FILE__, __LINE__, #cond); \
+        fprintf(stderr, __VA_ARGS__); \
+        fputc('\n', stderr); \
+    } \
+} while (0)
+
+static inline int checkResult() {
+    if (checkFailures) fprintf(stderr, "%d check(s) failed\n", checkFailures);
+    else printf("all checks passed\n");
+    return checkFailures ? 1 : 0;
+}
+
+#endif // SIM_CHECK_H
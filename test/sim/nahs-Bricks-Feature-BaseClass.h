@@ -0,0 +1,24 @@
+#ifndef SIM_NAHS_BRICKS_FEATURE_BASECLASS_H
+#define SIM_NAHS_BRICKS_FEATURE_BASECLASS_H
+
+// Host stand-in for nahs-Bricks-Feature-BaseClass (part of nahs-Bricks-Feature-All)
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+class NahsBricksFeatureBaseClass {
+    public:
+        virtual ~NahsBricksFeatureBaseClass() {}
+        virtual String getName() = 0;
+        virtual uint16_t getVersion() = 0;
+        virtual void begin() = 0;
+        virtual void start() = 0;
+        virtual void deliver(JsonDocument* out_json) = 0;
+        virtual void feedback(JsonDocument* in_json) = 0;
+        virtual void end() = 0;
+        virtual void printRTCdata() = 0;
+        virtual void printFSdata() = 0;
+        virtual void brickSetupHandover() = 0;
+};
+
+#endif // SIM_NAHS_BRICKS_FEATURE_BASECLASS_H
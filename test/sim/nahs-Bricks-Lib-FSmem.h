@@ -0,0 +1,26 @@
+#ifndef SIM_NAHS_BRICKS_LIB_FSMEM_H
+#define SIM_NAHS_BRICKS_LIB_FSMEM_H
+
+// Host stand-in for nahs-Bricks-Lib-FSmem: a single document that survives sleep() and power cycles of the simulation
+
+#include <ArduinoJson.h>
+
+class NahsBricksLibFSmem {
+    public:
+        static const size_t CAPACITY = 4096;  // json document of a brick, shared by all features
+
+        NahsBricksLibFSmem() : _doc(CAPACITY) {}
+        JsonObject registerData(const char* name) {
+            if (!_doc.containsKey(name)) _doc.createNestedObject(name);
+            return _doc[name].as<JsonObject>();
+        }
+        void clear() { _doc.clear(); }  // wipes the flash
+        JsonDocument& doc() { return _doc; }
+
+    private:
+        DynamicJsonDocument _doc;
+};
+
+extern NahsBricksLibFSmem FSmem;
+
+#endif // SIM_NAHS_BRICKS_LIB_FSMEM_H
@@ -0,0 +1,26 @@
+#ifndef SIM_NAHS_BRICKS_LIB_HDC1080_H
+#define SIM_NAHS_BRICKS_LIB_HDC1080_H
+
+// Host stand-in for nahs-Bricks-Lib-HDC1080, measures temperature and humidity in one go (14bit each)
+
+#include <Arduino.h>
+
+typedef uint8_t HDC1080_SerialNumber[5];
+
+class NahsBricksLibHDC1080 {
+    public:
+        bool begin();
+        bool isConnected();
+        void getSN(HDC1080_SerialNumber sn);
+        String snToString(const HDC1080_SerialNumber sn);
+        void triggerRead();
+        float getT();
+        float getH() { return _h; }
+
+    private:
+        float _h = NAN;
+};
+
+extern NahsBricksLibHDC1080 HDC1080;
+
+#endif // SIM_NAHS_BRICKS_LIB_HDC1080_H
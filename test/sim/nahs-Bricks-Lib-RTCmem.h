@@ -0,0 +1,38 @@
+#ifndef SIM_NAHS_BRICKS_LIB_RTCMEM_H
+#define SIM_NAHS_BRICKS_LIB_RTCMEM_H
+
+// Host stand-in for nahs-Bricks-Lib-RTCmem: blocks are handed out in order of registration and survive sleep() of the simulation
+
+#include <Arduino.h>
+
+class NahsBricksLibRTCmem {
+    public:
+        static const size_t SIZE = 512;  // RTC user memory of an ESP8266 (on a brick it is shared with the Brick OS)
+
+        template<class T> T* registerData() {
+            _used = (_used + 3) & ~(size_t)3;  // 4 byte aligned like RTC memory
+            if (_used + sizeof(T) > SIZE) {
+                fprintf(stderr, "RTCmem exhausted: %zu of %zu bytes used, %zu more requested\n", _used, SIZE, sizeof(T));
+                abort();
+            }
+            T* data = reinterpret_cast<T*>(_data + _used);
+            _used += sizeof(T);
+            return data;
+        }
+        bool isValid() { return _valid; }
+        size_t used() const { return _used; }
+        void boot(bool valid) {  // a new wake registers all blocks again
+            _used = 0;
+            _valid = valid;
+            if (!valid) memset(_data, 0xA5, sizeof(_data));  // content is undefined after power-on
+        }
+
+    private:
+        alignas(8) uint8_t _data[SIZE];
+        size_t _used = 0;
+        bool _valid = false;
+};
+
+extern NahsBricksLibRTCmem RTCmem;
+
+#endif // SIM_NAHS_BRICKS_LIB_RTCMEM_H
@@ -0,0 +1,26 @@
+#ifndef SIM_NAHS_BRICKS_LIB_SHT4X_H
+#define SIM_NAHS_BRICKS_LIB_SHT4X_H
+
+// Host stand-in for nahs-Bricks-Lib-SHT4x, measures with high repeatability
+
+#include <Arduino.h>
+
+typedef uint8_t SHT4x_SerialNumber[4];
+
+class NahsBricksLibSHT4x {
+    public:
+        bool begin() { return isConnected(); }
+        bool isConnected();
+        void getSN(SHT4x_SerialNumber sn);
+        String snToString(const SHT4x_SerialNumber sn);
+        void triggerRead();
+        float getT();
+        float getH() { return _h; }
+
+    private:
+        float _h = NAN;
+};
+
+extern NahsBricksLibSHT4x SHT4x;
+
+#endif // SIM_NAHS_BRICKS_LIB_SHT4X_H
@@ -0,0 +1,16 @@
+#ifndef SIM_NAHS_BRICKS_LIB_SERHELP_H
+#define SIM_NAHS_BRICKS_LIB_SERHELP_H
+
+// Host stand-in for nahs-Bricks-Lib-SerHelp, lines are taken from sim::queueInput()
+
+#include <Arduino.h>
+
+class NahsBricksLibSerHelp {
+    public:
+        String readLine();
+        void printlnBool(bool value) { Serial.println(value ? "true" : "false"); }
+};
+
+extern NahsBricksLibSerHelp SerHelp;
+
+#endif // SIM_NAHS_BRICKS_LIB_SERHELP_H
@@ -0,0 +1,427 @@
+#include "sim.h"
+#include <Arduino.h>
+#include <Wire.h>
+#include <nahs-Bricks-Lib-HDC1080.h>
+#include <nahs-Bricks-Lib-SHT4x.h>
+#include <nahs-Bricks-Lib-RTCmem.h>
+#include <nahs-Bricks-Lib-FSmem.h>
+#include <nahs-Bricks-Lib-SerHelp.h>
+
+//------------------------------------------
+// globally predefined variables of the stand-ins
+HardwareSerial Serial;
+TwoWire Wire;
+NahsBricksLibHDC1080 HDC1080;
+NahsBricksLibSHT4x SHT4x;
+NahsBricksLibRTCmem RTCmem;
+NahsBricksLibFSmem FSmem;
+NahsBricksLibSerHelp SerHelp;
+
+namespace sim {
+
+uint64_t clockUs = 0;
+uint64_t wakeStartUs = 0;
+Stats stats = {};
+HDC1080Chip hdc1080 = {};
+SHT4xChip sht4x = {};
+bool echoSerial = false;
+
+static OneWireBus _buses[BUS_MAX];
+static const uint8_t INPUT_MAX = 32;
+static const char* _input[INPUT_MAX];
+static uint8_t _inputHead = 0;
+static uint8_t _inputTail = 0;
+
+void reset() {
+    memset(_buses, 0, sizeof(_buses));
+    hdc1080 = HDC1080Chip();
+    sht4x = SHT4xChip();
+    _inputHead = _inputTail = 0;
+    resetStats();
+}
+
+void resetStats() {
+    stats = Stats();
+}
+
+void advance(uint64_t us) {
+    clockUs += us;
+}
+
+OneWireBus* bus(uint8_t pin) {
+    for (uint8_t b = 0; b < BUS_MAX; ++b) {
+        if (_buses[b].used && _buses[b].pin == pin) return &_buses[b];
+    }
+    for (uint8_t b = 0; b < BUS_MAX; ++b) {
+        if (_buses[b].used) continue;
+        _buses[b].used = true;
+        _buses[b].pin = pin;
+        return &_buses[b];
+    }
+    fprintf(stderr, "sim: too many OneWire buses\n");
+    abort();
+}
+
+/*
+Puts the power-on content (85 degree celsius and the EEPROM values) into the scratchpad of a DS18B20 (or DS18S20)
+*/
+static void _powerOn(DS18B20* dev) {
+    uint8_t* sp = dev->scratchpad;
+    bool s20 = dev->rom[0] == 0x10;
+    sp[0] = s20 ? 0xAA : 0x50;
+    sp[1] = s20 ? 0x00 : 0x05;
+    sp[2] = dev->eeprom[0];
+    sp[3] = dev->eeprom[1];
+    sp[4] = s20 ? 0xFF : dev->eeprom[2];
+    sp[5] = 0xFF;
+    sp[6] = 0x0C;
+    sp[7] = 0x10;
+    sp[8] = crc8(sp, 8);
+    dev->converting = false;
+}
+
+DS18B20* addDS18B20(uint8_t pin, uint32_t serial, float temp, bool parasite, uint8_t family) {
+    OneWireBus* b = bus(pin);
+    if (b->count >= BUS_SENSORS_MAX) {
+        fprintf(stderr, "sim: too many sensors on bus\n");
+        abort();
+    }
+    DS18B20* dev = &b->devices[b->count++];
+    memset(dev, 0, sizeof(DS18B20));
+    dev->rom[0] = family;
+    for (uint8_t i = 0; i < 4; ++i) dev->rom[1 + i] = (serial >> (8 * i)) & 0xFF;
+    dev->rom[5] = pin;
+    dev->rom[7] = crc8(dev->rom, 7);
+    dev->temp = temp;
+    dev->parasite = parasite;
+    dev->present = true;
+    dev->eeprom[0] = 0x4B;  // factory default TH of 75 degree celsius
+    dev->eeprom[1] = 0x46;  // factory default TL of 70 degree celsius
+    dev->eeprom[2] = 0x7F;  // 12bit
+    _powerOn(dev);
+    return dev;
+}
+
+void addHDC1080(float temp) {
+    hdc1080 = HDC1080Chip();
+    hdc1080.present = true;
+    hdc1080.temp = temp;
+    hdc1080.humidity = 45;
+    hdc1080.config = 0x1000;
+    const uint8_t serial[5] = {0x12, 0x34, 0x56, 0x78, 0x9A};
+    memcpy(hdc1080.serial, serial, sizeof(serial));
+}
+
+void addSHT4x(float temp) {
+    sht4x = SHT4xChip();
+    sht4x.present = true;
+    sht4x.temp = temp;
+    sht4x.humidity = 45;
+    const uint8_t serial[4] = {0xAB, 0xCD, 0xEF, 0x01};
+    memcpy(sht4x.serial, serial, sizeof(serial));
+}
+
+void powerCycle() {
+    for (uint8_t b = 0; b < BUS_MAX; ++b) {
+        for (uint8_t i = 0; i < _buses[b].count; ++i) _powerOn(&_buses[b].devices[i]);
+    }
+    hdc1080.config = 0x1000;
+    hdc1080.measuring = false;
+    hdc1080.measured = false;
+    hdc1080.pointer = 0;
+    sht4x.measured = false;
+}
+
+void startWake() {
+    wakeStartUs = clockUs;
+}
+
+void sleep(uint32_t seconds) {
+    advance((uint64_t)seconds * 1000000);
+}
+
+/*
+Dallas/Maxim CRC8 (polynomial x^8 + x^5 + x^4 + 1)
+*/
+uint8_t crc8(const uint8_t* data, uint8_t len) {
+    uint8_t crc = 0;
+    while (len--) {
+        uint8_t inbyte = *data++;
+        for (uint8_t i = 8; i; i--) {
+            uint8_t mix = (crc ^ inbyte) & 0x01;
+            crc >>= 1;
+            if (mix) crc ^= 0x8C;
+            inbyte >>= 1;
+        }
+    }
+    return crc;
+}
+
+const char* queueInput(const char* line) {
+    _input[_inputTail] = line;
+    _inputTail = (_inputTail + 1) % INPUT_MAX;
+    return line;
+}
+
+static const char* _nextInput() {
+    if (_inputHead == _inputTail) return "";
+    const char* line = _input[_inputHead];
+    _inputHead = (_inputHead + 1) % INPUT_MAX;
+    return line;
+}
+
+}  // namespace sim
+
+//------------------------------------------
+// time is driven by the simulation clock, millis() and micros() count since the start of the wake
+unsigned long millis() {
+    return (sim::clockUs - sim::wakeStartUs) / 1000;
+}
+
+unsigned long micros() {
+    return sim::clockUs - sim::wakeStartUs;
+}
+
+void delay(unsigned long ms) {
+    sim::advance((uint64_t)ms * 1000);
+}
+
+void delayMicroseconds(unsigned int us) {
+    sim::advance(us);
+}
+
+void yield() {}
+
+//------------------------------------------
+// SerHelp
+String NahsBricksLibSerHelp::readLine() {
+    return String(sim::_nextInput());
+}
+
+//------------------------------------------
+// I2C bus and chips
+void TwoWire::beginTransmission(uint8_t address) {
+    _address = address;
+    _txLen = 0;
+}
+
+size_t TwoWire::write(uint8_t data) {
+    if (_txLen >= BUFFER_SIZE) return 0;
+    _tx[_txLen++] = data;
+    return 1;
+}
+
+static void _i2cSpend(uint8_t bytes) {
+    uint64_t us = sim::I2C_START_US + (uint64_t)bytes * sim::I2C_BYTE_US;
+    sim::advance(us);
+    sim::stats.i2cUs += us;
+    sim::stats.i2cTransactions++;
+}
+
+static uint8_t _shtCrc(const uint8_t* data, uint8_t len) {  // polynomial 0x31, init 0xFF
+    uint8_t crc = 0xFF;
+    for (uint8_t i = 0; i < len; ++i) {
+        crc ^= data[i];
+        for (uint8_t b = 0; b < 8; ++b) crc = (crc & 0x80) ? (crc << 1) ^ 0x31 : (crc << 1);
+    }
+    return crc;
+}
+
+static uint16_t _hdcRawT(float t) {
+    return (uint16_t)constrain((t + 40) * 65536 / 165, 0.0f, 65535.0f);
+}
+
+static uint16_t _hdcRawH(float h) {
+    return (uint16_t)constrain(h * 65536 / 100, 0.0f, 65535.0f);
+}
+
+uint8_t TwoWire::endTransmission(bool) {
+    _i2cSpend(_txLen);
+    sim::HDC1080Chip& hdc = sim::hdc1080;
+    sim::SHT4xChip& sht = sim::sht4x;
+    if (_address == 0x40 && hdc.present) {
+        if (_txLen >= 1) hdc.pointer = _tx[0];
+        if (_txLen >= 3 && hdc.pointer == 0x02) hdc.config = (_tx[1] << 8) | _tx[2];
+        if (_txLen == 1 && hdc.pointer == 0x00) {
+            bool both = hdc.config & 0x1000;
+            bool lowT = hdc.config & 0x0400;
+            hdc.measuring = true;
+            hdc.measured = false;
+            hdc.doneAt = sim::clockUs + (lowT ? 3650 : 6350) + (both ? 6500 : 0);
+        }
+        return 0;
+    }
+    if (_address == 0x44 && sht.present) {
+        if (_txLen >= 1) {
+            sht.command = _tx[0];
+            uint32_t duration = 0;
+            if (sht.command == 0xFD) duration = 8300;
+            else if (sht.command == 0xF6) duration = 4500;
+            else if (sht.command == 0xE0) duration = 1600;
+            sht.measured = duration > 0;
+            sht.doneAt = sim::clockUs + duration;
+        }
+        return 0;
+    }
+    return 2;  // NACK on address
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t quantity) {
+    _rxLen = _rxPos = 0;
+    sim::HDC1080Chip& hdc = sim::hdc1080;
+    sim::SHT4xChip& sht = sim::sht4x;
+    uint8_t data[BUFFER_SIZE];
+    uint8_t len = 0;
+    if (address == 0x40 && hdc.present) {
+        if (hdc.pointer == 0x00) {
+            if (hdc.measuring && sim::clockUs >= hdc.doneAt) {
+                hdc.measuring = false;
+                hdc.measured = true;
+            }
+            if (!hdc.measured) {  // NACK while converting
+                _i2cSpend(0);
+                return 0;
+            }
+            uint16_t t = _hdcRawT(hdc.temp);
+            uint16_t h = _hdcRawH(hdc.humidity);
+            uint8_t values[4] = {(uint8_t)(t >> 8), (uint8_t)t, (uint8_t)(h >> 8), (uint8_t)h};
+            len = (hdc.config & 0x1000) ? 4 : 2;
+            memcpy(data, values, len);
+        }
+        else if (hdc.pointer == 0x02) {
+            data[0] = hdc.config >> 8;
+            data[1] = hdc.config & 0xFF;
+            len = 2;
+        }
+        else if (hdc.pointer == 0xFB) {
+            memcpy(data, hdc.serial, sizeof(hdc.serial));
+            len = sizeof(hdc.serial);
+        }
+    }
+    else if (address == 0x44 && sht.present) {
+        if (sht.command == 0x89) {
+            uint8_t sn[6] = {sht.serial[0], sht.serial[1], 0, sht.serial[2], sht.serial[3], 0};
+            sn[2] = _shtCrc(sn, 2);
+            sn[5] = _shtCrc(sn + 3, 2);
+            memcpy(data, sn, sizeof(sn));
+            len = sizeof(sn);
+        }
+        else if (sht.measured) {
+            if (sim::clockUs < sht.doneAt) {  // NACK while converting
+                _i2cSpend(0);
+                return 0;
+            }
+            uint16_t t = (uint16_t)constrain((sht.temp + 45) * 65535 / 175, 0.0f, 65535.0f);
+            uint16_t h = (uint16_t)constrain((sht.humidity + 6) * 65535 / 125, 0.0f, 65535.0f);
+            uint8_t values[6] = {(uint8_t)(t >> 8), (uint8_t)t, 0, (uint8_t)(h >> 8), (uint8_t)h, 0};
+            values[2] = _shtCrc(values, 2);
+            values[5] = _shtCrc(values + 3, 2);
+            memcpy(data, values, sizeof(values));
+            len = sizeof(values);
+            sht.measured = false;
+        }
+    }
+    if (len == 0) {
+        _i2cSpend(0);
+        return 0;
+    }
+    if (quantity < len) len = quantity;
+    memcpy(_rx, data, len);
+    _rxLen = len;
+    _i2cSpend(len);
+    return len;
+}
+
+static String _snToString(const uint8_t* sn, uint8_t len) {
+    String id;
+    char hex[3];
+    for (uint8_t i = 0; i < len; ++i) {
+        snprintf(hex, sizeof(hex), "%02x", sn[i]);
+        id += hex;
+    }
+    return id;
+}
+
+/*
+The chips libraries measure temperature and humidity at 14bit (HDC1080) or high repeatability (SHT4x)
+*/
+bool NahsBricksLibHDC1080::begin() {
+    if (!isConnected()) return false;
+    Wire.beginTransmission(0x40);
+    Wire.write(0x02);
+    Wire.write(0x10);
+    Wire.write(0x00);
+    Wire.endTransmission();
+    return true;
+}
+
+bool NahsBricksLibHDC1080::isConnected() {
+    Wire.beginTransmission(0x40);
+    return Wire.endTransmission() == 0;
+}
+
+void NahsBricksLibHDC1080::getSN(HDC1080_SerialNumber sn) {
+    Wire.beginTransmission(0x40);
+    Wire.write(0xFB);
+    Wire.endTransmission();
+    if (Wire.requestFrom(0x40, sizeof(HDC1080_SerialNumber)) != sizeof(HDC1080_SerialNumber)) return;
+    for (uint8_t i = 0; i < sizeof(HDC1080_SerialNumber); ++i) sn[i] = Wire.read();
+}
+
+String NahsBricksLibHDC1080::snToString(const HDC1080_SerialNumber sn) {
+    return _snToString(sn, sizeof(HDC1080_SerialNumber));
+}
+
+void NahsBricksLibHDC1080::triggerRead() {
+    Wire.beginTransmission(0x40);
+    Wire.write(0x00);
+    Wire.endTransmission();
+}
+
+float NahsBricksLibHDC1080::getT() {
+    _h = NAN;
+    if (Wire.requestFrom(0x40, 4) != 4) return NAN;
+    uint16_t t = Wire.read() << 8;
+    t |= Wire.read();
+    uint16_t h = Wire.read() << 8;
+    h |= Wire.read();
+    _h = h * 100.0f / 65536;
+    return t * 165.0f / 65536 - 40;
+}
+
+bool NahsBricksLibSHT4x::isConnected() {
+    Wire.beginTransmission(0x44);
+    return Wire.endTransmission() == 0;
+}
+
+void NahsBricksLibSHT4x::getSN(SHT4x_SerialNumber sn) {
+    Wire.beginTransmission(0x44);
+    Wire.write(0x89);
+    Wire.endTransmission();
+    uint8_t data[6];
+    if (Wire.requestFrom(0x44, sizeof(data)) != sizeof(data)) return;
+    for (uint8_t i = 0; i < sizeof(data); ++i) data[i] = Wire.read();
+    sn[0] = data[0];
+    sn[1] = data[1];
+    sn[2] = data[3];
+    sn[3] = data[4];
+}
+
+String NahsBricksLibSHT4x::snToString(const SHT4x_SerialNumber sn) {
+    return _snToString(sn, sizeof(SHT4x_SerialNumber));
+}
+
+void NahsBricksLibSHT4x::triggerRead() {
+    Wire.beginTransmission(0x44);
+    Wire.write(0xFD);
+    Wire.endTransmission();
+}
+
+float NahsBricksLibSHT4x::getT() {
+    _h = NAN;
+    uint8_t data[6];
+    if (Wire.requestFrom(0x44, sizeof(data)) != sizeof(data)) return NAN;
+    for (uint8_t i = 0; i < sizeof(data); ++i) data[i] = Wire.read();
+    _h = -6 + 125.0f * ((data[3] << 8) | data[4]) / 65535;
+    return -45 + 175.0f * ((data[0] << 8) | data[1]) / 65535;
+}
@@ -0,0 +1,106 @@
+#ifndef SIM_H
+#define SIM_H
+
+/*
+Simulated hardware of a brick: a microsecond clock, DS18B20 sensors on OneWire buses, HDC1080 and SHT4x on I2C.
+Bus transactions advance the clock by their duration on the wire, so begin() to end() of a wake can be timed.
+All state lives in static storage, the simulation itself never allocates.
+*/
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace sim {
+
+static const uint8_t BUS_MAX = 8;  // OneWire buses (identified by pin)
+static const uint8_t BUS_SENSORS_MAX = 64;  // DS18B20 per bus
+
+// durations of bus transactions (standard speed OneWire, 100kHz I2C)
+static const uint32_t OW_RESET_US = 960;  // reset pulse and presence detect
+static const uint32_t OW_SLOT_US = 65;  // one read or write time slot
+static const uint32_t OW_BYTE_US = 8 * OW_SLOT_US;
+static const uint32_t I2C_START_US = 100;  // start condition and address byte
+static const uint32_t I2C_BYTE_US = 90;
+
+struct Stats {
+    uint64_t oneWireUs;  // time spent on OneWire buses
+    uint64_t i2cUs;  // time spent on I2C
+    uint32_t resets;
+    uint32_t bytesWritten;
+    uint32_t bytesRead;
+    uint32_t slots;  // single bit slots (search, status polls)
+    uint32_t searches;  // devices found by (alarm) searches
+    uint32_t convertTs;  // Convert-T commands
+    uint32_t scratchpadReads;
+    uint32_t scratchpadWrites;
+    uint32_t eepromCopies;
+    uint32_t i2cTransactions;
+};
+
+struct DS18B20 {
+    uint8_t rom[8];
+    float temp;  // true temperature of the sensor in degree celsius
+    bool parasite;
+    bool present;
+    bool corrupt;  // reads of the scratchpad fail the CRC check
+    bool stuck;  // conversions do not update the scratchpad (keeps the power-on value)
+    uint8_t scratchpad[9];
+    uint8_t eeprom[3];  // TH, TL and configuration register
+    bool converting;
+    bool convPowered;  // strong pull-up was applied when the conversion started
+    uint64_t convDoneAt;
+};
+
+struct OneWireBus {
+    uint8_t pin;
+    bool used;
+    uint8_t count;
+    DS18B20 devices[BUS_SENSORS_MAX];
+};
+
+struct HDC1080Chip {
+    bool present;
+    float temp;
+    float humidity;
+    uint16_t config;
+    uint8_t pointer;
+    bool measuring;
+    bool measured;
+    uint64_t doneAt;
+    uint8_t serial[5];
+};
+
+struct SHT4xChip {
+    bool present;
+    float temp;
+    float humidity;
+    uint8_t command;
+    bool measured;
+    uint64_t doneAt;
+    uint8_t serial[4];
+};
+
+extern uint64_t clockUs;  // time since the simulation started
+extern uint64_t wakeStartUs;  // clockUs at the start of the current wake (millis() counts from here)
+extern Stats stats;
+extern HDC1080Chip hdc1080;
+extern SHT4xChip sht4x;
+extern uint64_t allocations;  // heap allocations since start (operator new and malloc)
+extern bool echoSerial;
+
+void reset();  // drops all devices and statistics
+void resetStats();
+void advance(uint64_t us);
+OneWireBus* bus(uint8_t pin);  // gets (or creates) the bus on pin
+DS18B20* addDS18B20(uint8_t pin, uint32_t serial, float temp, bool parasite = false, uint8_t family = 0x28);  // family 0x10 is a DS18S20
+void addHDC1080(float temp);
+void addSHT4x(float temp);
+void powerCycle();  // cold boot: sensors lose their scratchpad (recalled from EEPROM), chips their configuration
+void startWake();
+void sleep(uint32_t seconds);
+uint8_t crc8(const uint8_t* data, uint8_t len);
+const char* queueInput(const char* line);  // input for SerHelp.readLine()
+
+}  // namespace sim
+
+#endif // SIM_H
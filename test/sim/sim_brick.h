@@ -0,0 +1,72 @@
+#ifndef SIM_BRICK_H
+#define SIM_BRICK_H
+
+/*
+Runs the feature through wake cycles like the Brick OS does: RAM (the feature object) is lost on every
+deep sleep, RTCmem survives it, and a power cycle clears both.
+*/
+
+#include <new>
+#include <nahs-Bricks-Feature-Temp.h>
+#include "sim.h"
+
+class SimBrick {
+    public:
+        static const uint8_t PIN = D7;
+
+        ~SimBrick() { _destroy(); }
+
+        // cold boot: sensors lose their scratchpad and RTCmem is invalid
+        void powerOn() {
+            _destroy();
+            sim::powerCycle();
+            _rtcValid = false;
+        }
+
+        // starts a wake cycle (begin and start of the feature), the OS may be awake for osMs before begin()
+        NahsBricksFeatureTemp& wake(uint32_t osMs = 0) {
+            _destroy();
+            sim::startWake();
+            sim::advance((uint64_t)osMs * 1000);
+            RTCmem.boot(_rtcValid);
+            _feature = new (_storage) NahsBricksFeatureTemp();
+            for (uint8_t b = 0; b < TEMP_ONEWIRE_BUS_COUNT; ++b) _feature->setSensorsPin(PIN + b, b);
+            _feature->begin();
+            _feature->start();
+            return *_feature;
+        }
+
+        NahsBricksFeatureTemp& feature() { return *_feature; }
+
+        // ends the wake cycle and sleeps, returns the time the brick was awake (in microseconds)
+        uint64_t sleep(uint32_t seconds = 60) {
+            _feature->end();
+            uint64_t awake = sim::clockUs - sim::wakeStartUs;
+            _destroy();
+            _rtcValid = true;
+            sim::sleep(seconds);
+            return awake;
+        }
+
+        // complete wake cycle, out receives the delivered data, in (if given) is fed back
+        uint64_t cycle(JsonDocument& out, JsonDocument* in = nullptr, uint32_t seconds = 60) {
+            wake();
+            out.clear();
+            _feature->deliver(&out);
+            if (in != nullptr) _feature->feedback(in);
+            return sleep(seconds);
+        }
+
+    private:
+        alignas(NahsBricksFeatureTemp) uint8_t _storage[sizeof(NahsBricksFeatureTemp)];
+        NahsBricksFeatureTemp* _feature = nullptr;
+        bool _rtcValid = false;
+
+        void _destroy() {
+            if (_feature == nullptr) return;
+            _feature->~NahsBricksFeatureTemp();
+            _feature = nullptr;
+        }
+};
+
+#endif // SIM_BRICK_H
@@ -0,0 +1,96 @@
+/*
+deliver() must not touch the heap, for any number of sensors and with every mode and request that adds to the payload.
+The document is allocated by the caller, so every heap allocation counted during deliver() is one of the feature.
+Neither must begin() and start() of a warm wake (this includes rendering the sensor IDs).
+*/
+
+#include <nahs-Bricks-Feature-Temp.h>
+#include "sim/sim.h"
+#include "sim/sim_brick.h"
+#include "sim/check.h"
+
+static const uint8_t WAKES = 4;
+
+struct Scenario {
+    const char* name;
+    uint8_t sensors;
+    bool i2c;
+    void (*feedback)(JsonDocument& in);  // fed back on the cold wake
+};
+
+static SimBrick brick;
+
+static void requestAll(JsonDocument& in) {
+    JsonArray r = in.createNestedArray("r");
+    r.add(4);
+    r.add(6);
+    r.add(21);
+}
+
+static const Scenario scenarios[] = {
+    {"no sensors", 0, false, nullptr},
+    {"single sensor", 1, false, nullptr},
+    {"full bus", TEMP_MAX_SENSORS_COUNT, false, nullptr},
+    {"single-chip only", 0, true, nullptr},
+    {"all requests", TEMP_MAX_SENSORS_COUNT, true, requestAll},
+    {"centi format", 3, true, [](JsonDocument& in) { in["tf"] = 1; }},
+    {"compact payload", 3, true, [](JsonDocument& in) { in["tcp"] = 1; }},
+    {"deadband", 3, true, [](JsonDocument& in) { in["tdb"] = 50; in["tms"] = 2; }},
+    {"median filter", 3, true, [](JsonDocument& in) { in["tfm"] = 1; in["tfn"] = 3; }},
+    {"ema filter", 3, true, [](JsonDocument& in) { in["tfm"] = 2; in["tfn"] = 2; }},
+    {"adaptive precision", 3, false, [](JsonDocument& in) { in["tpa"] = true; }},
+    {"batching", 3, true, [](JsonDocument& in) { in["tbf"] = 2; in["tbs"] = 2; requestAll(in); }},
+    {"alarm mode", 3, false, [](JsonDocument& in) { in["tam"] = true; }},
+};
+
+static void run(const Scenario& s) {
+    sim::reset();
+    FSmem.clear();
+    for (uint8_t i = 0; i < s.sensors; ++i) sim::addDS18B20(SimBrick::PIN, 0x2000 + i, 18 + i * 0.5f);
+    if (s.i2c) {
+        sim::addHDC1080(21.5f);
+        sim::addSHT4x(22.5f);
+    }
+    DynamicJsonDocument out(NahsBricksFeatureTemp::maxDeliverCapacity());
+    DynamicJsonDocument in(512);
+    DynamicJsonDocument ack(64);
+
+    brick.powerOn();
+    for (uint8_t w = 0; w < WAKES; ++w) {
+        uint64_t allocations = sim::allocations;
+        NahsBricksFeatureTemp& feature = brick.wake();
+        uint64_t allocated = sim::allocations - allocations;
+        if (w > 0) {  // a cold wake searches the buses and loads FSmem
+            CHECK(allocated == 0, "%s: begin() and start() allocated %llu times on wake %u", s.name, (unsigned long long)allocated, w);
+        }
+        out.clear();
+        allocations = sim::allocations;
+        feature.deliver(&out);
+        allocated = sim::allocations - allocations;
+        CHECK(allocated == 0, "%s: deliver() allocated %llu times on wake %u", s.name, (unsigned long long)allocated, w);
+        CHECK(!out.overflowed(), "%s: document overflowed on wake %u", s.name, w);
+
+        if (w == 0 && s.feedback != nullptr) {
+            in.clear();
+            s.feedback(in);
+            feature.feedback(&in);
+        }
+        if (out.containsKey("th")) {  // BrickServer acknowledges the channel table
+            ack.clear();
+            ack["th"] = out["th"].as<uint32_t>();
+            feature.feedback(&ack);
+        }
+        brick.sleep();
+        sim::hdc1080.temp += 1;  // keeps deadband from skipping everything
+        sim::sht4x.temp += 1;
+    }
+}
+
+int main() {
+    uint64_t allocations = sim::allocations;
+    String counted("allocates");
+    CHECK(sim::allocations > allocations, "allocation counter does not count");
+
+    for (const Scenario& s : scenarios) run(s);
+    return checkResult();
+}
@@ -0,0 +1,172 @@
+/*
+Correction table in FSmem: migration of the former sCorr dict and calibration feedback write the table once per operation,
+so the FSmem document only grows by the size of the final table. A migration that does not fit keeps sCorr to retry it.
+Corrections that do not fit into the table (beyond +-255 degree) are rejected.
+*/
+
+#include <ctype.h>
+#include <nahs-Bricks-Feature-Temp.h>
+#include "sim/sim.h"
+#include "sim/sim_brick.h"
+#include "sim/check.h"
+
+static const uint8_t SENSORS = 3;
+static const uint8_t RECORDS = 40;  // stored corrections, most of them of sensors not connected
+static const size_t RECORD_CHARS = 24;
+
+static SimBrick brick;
+static char ids[SENSORS][17];
+
+// corrections of the connected sensors as delivered
+static void deliverCorrs(JsonDocument& out) {
+    DynamicJsonDocument in(64);
+    in.createNestedArray("r").add(4);
+    brick.cycle(out, &in);
+    brick.cycle(out);
+}
+
+static float deliveredCorr(JsonDocument& out, const char* id) {
+    for (JsonVariant entry : out["c"].as<JsonArray>()) {
+        if (strcmp(entry[0].as<const char*>(), id) == 0) return entry[1].as<float>();
+    }
+    return NAN;
+}
+
+static const char* table() {
+    const char* c = FSmem.doc()["tc"]["c"].as<const char*>();
+    return (c == nullptr) ? "" : c;
+}
+
+static bool sorted(const char* t) {
+    size_t n = strlen(t) / RECORD_CHARS;
+    for (size_t i = 1; i < n; ++i) {
+        if (strncmp(t + (i - 1) * RECORD_CHARS, t + i * RECORD_CHARS, 16) >= 0) return false;
+    }
+    return true;
+}
+
+// powers on with SENSORS sensors and learns their IDs, leaves the brick asleep
+static void setup() {
+    sim::reset();
+    FSmem.clear();
+    for (uint8_t i = 0; i < SENSORS; ++i) sim::addDS18B20(SimBrick::PIN, 0x4000 + i, 20 + i);
+    DynamicJsonDocument out(NahsBricksFeatureTemp::maxDeliverCapacity());
+    brick.powerOn();
+    brick.cycle(out);
+    for (uint8_t i = 0; i < SENSORS; ++i) strcpy(ids[i], out["t"][i][0].as<const char*>());
+}
+
+// former sCorr dict with the connected sensors (uppercase, like BrickServer used to send them) and RECORDS - SENSORS others
+static void writeCorrMap() {
+    JsonObject sCorr = FSmem.registerData("t").createNestedObject("sCorr");
+    char id[17];
+    for (uint8_t i = SENSORS; i < RECORDS; ++i) {
+        snprintf(id, sizeof(id), "28%012X%02X", (unsigned)(0x9000 - i * 7), i);
+        sCorr[String(id)] = i * 0.25f;
+    }
+    for (uint8_t i = 0; i < SENSORS; ++i) {
+        for (uint8_t c = 0; c < 16; ++c) id[c] = toupper(ids[i][c]);
+        id[16] = '\0';
+        sCorr[String(id)] = -1.5f - i;
+    }
+}
+
+static void testMigration() {
+    setup();
+    writeCorrMap();
+    size_t before = FSmem.doc().memoryUsage();
+    DynamicJsonDocument out(NahsBricksFeatureTemp::maxDeliverCapacity());
+    brick.powerOn();
+    deliverCorrs(out);
+
+    CHECK(!FSmem.doc()["t"].containsKey("sCorr"), "sCorr not removed after migration");
+    CHECK(strlen(table()) == RECORDS * RECORD_CHARS, "%zu records migrated", strlen(table()) / RECORD_CHARS);
+    CHECK(sorted(table()), "correction table not sorted");
+    CHECK(!FSmem.doc().overflowed(), "FSmem overflowed");
+    CHECK(FSmem.doc().memoryUsage() <= before + RECORDS * RECORD_CHARS + 1, "FSmem grew by %zu bytes for a table of %zu",
+        FSmem.doc().memoryUsage() - before, RECORDS * RECORD_CHARS);
+    for (uint8_t i = 0; i < SENSORS; ++i) {
+        CHECK(deliveredCorr(out, ids[i]) == -1.5f - i, "%s: correction %f", ids[i], deliveredCorr(out, ids[i]));
+    }
+}
+
+static void testMigrationWithoutRoom() {
+    setup();
+    writeCorrMap();
+    size_t room = FSmem.doc().capacity() - FSmem.doc().memoryUsage();
+    String pad;
+    for (size_t i = 0; i + RECORDS * RECORD_CHARS / 2 < room; ++i) pad += 'x';  // leaves less room than the table needs
+    FSmem.doc()["pad"] = pad;
+    DynamicJsonDocument out(NahsBricksFeatureTemp::maxDeliverCapacity());
+    brick.powerOn();
+    brick.cycle(out);
+
+    CHECK(FSmem.doc()["t"].containsKey("sCorr"), "sCorr removed although the table was not stored");
+    CHECK(strlen(table()) == 0, "partial table of %zu records stored", strlen(table()) / RECORD_CHARS);
+
+    FSmem.clear();  // room is made in flash, which still holds sCorr and no table
+    writeCorrMap();
+    brick.powerOn();
+    deliverCorrs(out);
+    CHECK(!FSmem.doc()["t"].containsKey("sCorr"), "sCorr not removed after the retried migration");
+    CHECK(strlen(table()) == RECORDS * RECORD_CHARS, "%zu records migrated on retry", strlen(table()) / RECORD_CHARS);
+}
+
+static void testCalibrationBatch() {
+    setup();
+    size_t before = FSmem.doc().memoryUsage();
+    DynamicJsonDocument out(NahsBricksFeatureTemp::maxDeliverCapacity());
+    DynamicJsonDocument in(4096);
+    JsonArray tg = in.createNestedArray("tg");
+    char id[17];
+    for (uint8_t i = 0; i < RECORDS; ++i) {
+        JsonArray entry = tg.createNestedArray();
+        if (i < SENSORS) entry.add(ids[i]);
+        else {
+            snprintf(id, sizeof(id), "28%012x%02x", (unsigned)(0x9000 - i * 7), i);
+            entry.add(String(id));
+        }
+        entry.add(1.0f);
+        entry.add(0.5f + i);
+    }
+    brick.cycle(out, &in);
+    deliverCorrs(out);
+
+    CHECK(strlen(table()) == RECORDS * RECORD_CHARS, "%zu records stored", strlen(table()) / RECORD_CHARS);
+    CHECK(sorted(table()), "correction table not sorted");
+    CHECK(FSmem.doc().memoryUsage() <= before + RECORDS * RECORD_CHARS + 1, "FSmem grew by %zu bytes for a table of %zu",
+        FSmem.doc().memoryUsage() - before, RECORDS * RECORD_CHARS);
+    for (uint8_t i = 0; i < SENSORS; ++i) {
+        CHECK(deliveredCorr(out, ids[i]) == 0.5f + i, "%s: correction %f", ids[i], deliveredCorr(out, ids[i]));
+    }
+}
+
+static void testCorrectionRange() {
+    setup();
+    DynamicJsonDocument out(NahsBricksFeatureTemp::maxDeliverCapacity());
+    DynamicJsonDocument in(512);
+    JsonArray tg = in.createNestedArray("tg");
+    static const float corrs[SENSORS] = {300.0f, -255.0f, 1.5f};  // the first does not fit into the int16 of the table
+    for (uint8_t i = 0; i < SENSORS; ++i) {
+        JsonArray entry = tg.createNestedArray();
+        entry.add(ids[i]);
+        entry.add(1.0f);
+        entry.add(corrs[i]);
+    }
+    brick.cycle(out, &in);
+    deliverCorrs(out);
+
+    CHECK(strlen(table()) == (SENSORS - 1) * RECORD_CHARS, "%zu records stored", strlen(table()) / RECORD_CHARS);
+    CHECK(deliveredCorr(out, ids[0]) == 0, "%s: correction %f out of range applied", ids[0], deliveredCorr(out, ids[0]));
+    for (uint8_t i = 1; i < SENSORS; ++i) {
+        CHECK(deliveredCorr(out, ids[i]) == corrs[i], "%s: correction %f", ids[i], deliveredCorr(out, ids[i]));
+    }
+}
+
+int main() {
+    testMigration();
+    testMigrationWithoutRoom();
+    testCalibrationBatch();
+    testCorrectionRange();
+    return checkResult();
+}
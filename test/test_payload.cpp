@@ -0,0 +1,289 @@
+/*
+deliverCapacity() and deliverSize() against real payloads: every wake of every scenario delivers into a document of
+exactly deliverCapacity(), which must not overflow, and the serialized json must not exceed deliverSize().
+deliverCapacity() must never exceed maxDeliverCapacity(). Both are upper bounds, the capacity is checked for equality
+on wakes on which every read fails (where the estimate is exact) or every read succeeds (one slot per channel less).
+*/
+
+#include <nahs-Bricks-Feature-Temp.h>
+#include "sim/sim.h"
+#include "sim/sim_brick.h"
+#include "sim/check.h"
+
+static const uint8_t WAKES = 8;
+
+struct Scenario {
+    const char* name;
+    uint8_t sensors;
+    bool hdc1080;
+    bool sht4x;
+    void (*step)(uint8_t wake, JsonDocument& out, JsonDocument& in);  // changes the hardware or feeds back after deliver()
+};
+
+static SimBrick brick;
+static sim::DS18B20* sensors[TEMP_MAX_SENSORS_COUNT + 1];
+
+static void requestAll(JsonDocument& in) {
+    JsonArray r = in.createNestedArray("r");
+    r.add(4);
+    r.add(6);
+    r.add(21);
+}
+
+static const char* firstID(JsonDocument& out) {
+    if (out.containsKey("ti")) return out["ti"][0].as<const char*>();
+    return out["t"][0][0].as<const char*>();
+}
+
+static const Scenario scenarios[] = {
+    {"no sensors", 0, false, false, nullptr},
+    {"single sensor", 1, false, false, nullptr},
+    {"three sensors", 3, false, false, nullptr},
+    {"full bus", TEMP_MAX_SENSORS_COUNT, false, false, nullptr},
+    {"hdc1080 only", 0, true, false, nullptr},
+    {"single-chips only", 0, true, true, nullptr},
+    {"requests", 3, true, true, [](uint8_t wake, JsonDocument&, JsonDocument& in) {
+        JsonArray r = in.createNestedArray("r");
+        r.add((wake % 3 == 0) ? 4 : (wake % 3 == 1) ? 6 : 21);
+    }},
+    {"all requests, full bus", TEMP_MAX_SENSORS_COUNT, true, true, [](uint8_t, JsonDocument&, JsonDocument& in) { requestAll(in); }},
+    {"topology change", 2, true, false, [](uint8_t wake, JsonDocument&, JsonDocument& in) {
+        if (wake == 1) sensors[2] = sim::addDS18B20(SimBrick::PIN, 0x3002, 23.5f);
+        if (wake == 3) sensors[0]->present = false;
+        if (wake == 1 || wake == 3) in["trs"] = true;
+        requestAll(in);
+    }},
+    {"read errors", 3, true, true, [](uint8_t wake, JsonDocument&, JsonDocument& in) {
+        if (wake == 1) sensors[0]->corrupt = true;
+        if (wake == 2) sensors[1]->present = false;
+        if (wake == 3) sim::hdc1080.present = false;
+        if (wake == 5) {
+            sensors[0]->corrupt = false;
+            sensors[1]->present = true;
+            sim::hdc1080.present = true;
+        }
+        in.createNestedArray("r").add(21);
+    }},
+    {"centi format", 3, true, true, [](uint8_t wake, JsonDocument&, JsonDocument& in) {
+        if (wake == 0) in["tf"] = 1;
+        requestAll(in);
+    }},
+    {"compact payload", 3, true, true, [](uint8_t wake, JsonDocument& out, JsonDocument& in) {
+        if (wake == 0) in["tcp"] = 1;
+        if (out.containsKey("th") && wake != 4) in["th"] = out["th"].as<uint32_t>();  // not acknowledged once
+        if (wake == 5) sensors[1]->corrupt = true;
+        if (wake == 6) requestAll(in);
+    }},
+    {"compact payload, table change", 3, true, false, [](uint8_t wake, JsonDocument& out, JsonDocument& in) {
+        if (wake == 0) in["tcp"] = 1;
+        if (out.containsKey("th")) in["th"] = out["th"].as<uint32_t>();
+        if (wake == 3) {
+            sensors[3] = sim::addDS18B20(SimBrick::PIN, 0x3003, 30.0f);
+            in["trs"] = true;
+        }
+    }},
+    {"batching", 3, true, true, [](uint8_t wake, JsonDocument&, JsonDocument& in) {
+        if (wake == 0) {
+            in["tbf"] = 3;
+            in["tbs"] = 2;
+        }
+        if (wake == 2) requestAll(in);
+    }},
+    {"batching, compact", 3, true, true, [](uint8_t wake, JsonDocument& out, JsonDocument& in) {
+        if (wake == 0) {
+            in["tcp"] = 1;
+            in["tbf"] = 2;
+            in["tbs"] = 1;
+        }
+        if (out.containsKey("th")) in["th"] = out["th"].as<uint32_t>();
+        if (wake == 4) sensors[2]->corrupt = true;
+    }},
+    {"batching, single-chip sensor lost", 3, true, true, [](uint8_t wake, JsonDocument& out, JsonDocument& in) {
+        static char ids[5][17];  // channels and their readings (in 1/100 degree celsius) as delivered on the first wake
+        static int16_t values[5];
+        static uint8_t flushes = 0;
+        if (wake == 0) {
+            for (uint8_t ch = 0; ch < 5; ++ch) {
+                strcpy(ids[ch], out["t"][ch][0].as<const char*>());
+                values[ch] = lroundf(out["t"][ch][1].as<float>() * 100);
+            }
+            flushes = 0;
+            in["tbf"] = 4;
+            in["tbs"] = 4;
+        }
+        if (wake == 1) sim::hdc1080.present = false;  // the first sample is buffered with the HDC1080
+        if (out.containsKey("tb")) ++flushes;
+        for (uint8_t s = 1; s < out["tb"].size(); ++s) {  // every sample matches the channel table in front of it
+            for (uint8_t i = 0; i < out["tb"][0].size(); ++i) {
+                const char* id = out["tb"][0][i].as<const char*>();
+                int16_t value = out["tb"][s][i + 1].as<int16_t>();
+                for (uint8_t ch = 0; ch < 5; ++ch) {
+                    if (strcmp(ids[ch], id) == 0) CHECK(value == values[ch], "tb sample %u: %s has %d on wake %u", s, id, value, wake);
+                }
+            }
+        }
+        if (wake == WAKES - 1) CHECK(flushes > 0 || TEMP_BATCH_BUFFER_SLOTS == 0, "batch not flushed");
+    }},
+    {"other families", 0, false, false, [](uint8_t wake, JsonDocument& out, JsonDocument& in) {
+        static const uint8_t families[] = {0x10, 0x22, 0x3B};  // DS18S20, DS1822, DS1825
+        static const float temps[] = {-10.3125f, 21.5625f, 85.0625f};
+        if (wake == 0) {
+            for (uint8_t i = 0; i < 3; ++i) sensors[i] = sim::addDS18B20(SimBrick::PIN, 0x5000 + i, temps[i], false, families[i]);
+            in["trs"] = true;
+            in["p"] = 12;
+            return;
+        }
+        CHECK(out["t"].size() == 3u, "%u of 3 sensors delivered on wake %u", (unsigned)out["t"].size(), wake);
+        for (JsonVariant entry : out["t"].as<JsonArray>()) {
+            const char* id = entry[0].as<const char*>();
+            float t = entry[1].as<float>();
+            for (uint8_t i = 0; i < 3; ++i) {
+                char family[3] = {id[0], id[1], '\0'};
+                if (strtoul(family, nullptr, 16) != families[i]) continue;
+                CHECK(fabsf(t - temps[i]) < 0.07f, "%s delivered %f instead of %f on wake %u", id, t, temps[i], wake);
+            }
+        }
+    }},
+    {"deadband", 3, true, true, [](uint8_t wake, JsonDocument&, JsonDocument& in) {
+        if (wake == 0) {
+            in["tdb"] = 50;
+            in["tms"] = 3;
+        }
+        if (wake == 4) sensors[0]->temp += 2;
+    }},
+    {"extreme temperatures", 3, true, true, [](uint8_t wake, JsonDocument& out, JsonDocument& in) {
+        if (wake == 0) {
+            sensors[0]->temp = -55;
+            sensors[1]->temp = 125;
+            sensors[2]->temp = -10.0625f;
+            sim::hdc1080.temp = -40;
+            sim::sht4x.temp = 125;
+            JsonArray tps = in.createNestedArray("tps");
+            JsonArray entry = tps.createNestedArray();
+            entry.add(firstID(out));
+            entry.add(12);
+        }
+        if (wake == 2) in["tf"] = 1;
+        requestAll(in);
+    }},
+    {"calibration and gains", 3, true, true, [](uint8_t wake, JsonDocument& out, JsonDocument& in) {
+        if (wake == 1) {
+            JsonArray tg = in.createNestedArray("tg");
+            JsonArray entry = tg.createNestedArray();
+            entry.add(firstID(out));
+            entry.add(1.0123456);
+            entry.add(-12.3456789);
+        }
+        requestAll(in);
+    }},
+    {"filters", 3, true, true, [](uint8_t wake, JsonDocument&, JsonDocument& in) {
+        if (wake == 0) {
+            in["tfm"] = 2;
+            in["tfn"] = 4;
+        }
+        if (wake == 4) in["tfm"] = 1;
+        sensors[0]->temp += 0.3f;
+        sim::hdc1080.temp -= 0.7f;
+    }},
+    {"measurement modes", 1, true, true, [](uint8_t wake, JsonDocument& out, JsonDocument& in) {
+        if (wake == 0) {
+            JsonArray tim = in.createNestedArray("tim");
+            JsonArray entry = tim.createNestedArray();
+            entry.add(out["t"][1][0].as<const char*>());
+            entry.add(TEMP_I2C_MODE_LOW);
+            entry = tim.createNestedArray();
+            entry.add(out["t"][2][0].as<const char*>());
+            entry.add(TEMP_I2C_MODE_MEDIUM);
+        }
+        requestAll(in);
+    }},
+};
+
+static void run(const Scenario& s) {
+    sim::reset();
+    FSmem.clear();
+    for (uint8_t i = 0; i < s.sensors; ++i) sensors[i] = sim::addDS18B20(SimBrick::PIN, 0x3000 + i, 20.5f + i);
+    if (s.hdc1080) sim::addHDC1080(21.25f);
+    if (s.sht4x) sim::addSHT4x(22.75f);
+    DynamicJsonDocument in(1024);
+
+    size_t maxCapacity = 0;  // largest estimate and the usage at the same time
+    size_t maxUsage = 0;
+    size_t maxSize = 0;
+    size_t maxBytes = 0;
+    brick.powerOn();
+    for (uint8_t w = 0; w < WAKES; ++w) {
+        NahsBricksFeatureTemp& feature = brick.wake();
+        size_t capacity = feature.deliverCapacity();
+        size_t size = feature.deliverSize();
+        CHECK(capacity <= NahsBricksFeatureTemp::maxDeliverCapacity(), "%s: capacity %zu above max %zu on wake %u",
+            s.name, capacity, NahsBricksFeatureTemp::maxDeliverCapacity(), w);
+
+        DynamicJsonDocument out(capacity);
+        feature.deliver(&out);
+        size_t bytes = out.isNull() ? 0 : measureJson(out) - 2;  // without the braces of the document
+        String json;
+        serializeJson(out, json);
+        CHECK(!out.overflowed(), "%s: capacity %zu too small on wake %u: %s", s.name, capacity, w, json.c_str());
+        CHECK(out.memoryUsage() <= capacity, "%s: used %zu of %zu on wake %u", s.name, out.memoryUsage(), capacity, w);
+        CHECK(bytes <= size, "%s: %zu bytes above estimate of %zu on wake %u: %s", s.name, bytes, size, w, json.c_str());
+        if (capacity > maxCapacity) {
+            maxCapacity = capacity;
+            maxUsage = out.memoryUsage();
+        }
+        if (size > maxSize) {
+            maxSize = size;
+            maxBytes = bytes;
+        }
+
+        in.clear();
+        if (s.step != nullptr) s.step(w, out, in);
+        if (!in.isNull()) feature.feedback(&in);
+        brick.sleep();
+    }
+    printf("%-32s capacity %5zu used %5zu   size %5zu serialized %5zu\n", s.name, maxCapacity, maxUsage, maxSize, maxBytes);
+}
+
+// the capacity is exact if every read fails and one slot per channel above the usage if every read succeeds
+static void testExactCapacity(bool compact) {
+    const char* name = compact ? "exact capacity, compact" : "exact capacity";
+    sim::reset();
+    FSmem.clear();
+    for (uint8_t i = 0; i < 3; ++i) sensors[i] = sim::addDS18B20(SimBrick::PIN, 0x3000 + i, 20.5f + i);
+    sim::addHDC1080(21.25f);
+    sim::addSHT4x(22.75f);
+    static const uint8_t CHANNELS = 5;
+    DynamicJsonDocument in(256);
+
+    brick.powerOn();
+    for (uint8_t w = 0; w < 5; ++w) {
+        bool failing = (w == 4);
+        if (failing) {
+            for (uint8_t i = 0; i < 3; ++i) sensors[i]->corrupt = true;
+            sim::hdc1080.present = false;
+            sim::sht4x.present = false;
+        }
+        NahsBricksFeatureTemp& feature = brick.wake();
+        size_t capacity = feature.deliverCapacity();
+        DynamicJsonDocument out(capacity);
+        feature.deliver(&out);
+        size_t expected = failing ? capacity : capacity - JSON_ARRAY_SIZE(CHANNELS);
+        if (w > 0) {  // the cold wake also delivers the topology
+            CHECK(out.memoryUsage() == expected, "%s: used %zu, expected %zu of %zu on wake %u", name, out.memoryUsage(), expected, capacity, w);
+        }
+
+        in.clear();
+        if (compact && w == 0) in["tcp"] = 1;
+        if (out.containsKey("th")) in["th"] = out["th"].as<uint32_t>();
+        if (!in.isNull()) feature.feedback(&in);
+        brick.sleep();
+    }
+}
+
+int main() {
+    printf("maxDeliverCapacity: %zu bytes\n", NahsBricksFeatureTemp::maxDeliverCapacity());
+    for (const Scenario& s : scenarios) run(s);
+    testExactCapacity(false);
+    testExactCapacity(true);
+    return checkResult();
+}
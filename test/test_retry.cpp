@@ -0,0 +1,65 @@
+/*
+Retries of failing DS18B20 reads: the deadline counts from begin(), so a sensor failing on a wake on which the OS was
+awake for a while before begin() is retried like on any other wake, and a retry that would end after the deadline is not done.
+*/
+
+#include <nahs-Bricks-Feature-Temp.h>
+#include "sim/sim.h"
+#include "sim/sim_brick.h"
+#include "sim/check.h"
+
+static SimBrick brick;
+static sim::DS18B20* sensor;
+
+// warm wake with a failing sensor, the OS is awake for osMs before begin() and workMs between start() and deliver()
+static sim::Stats failingWake(bool corrupt, uint32_t osMs, uint32_t workMs = 0) {
+    sim::reset();
+    FSmem.clear();
+    sensor = sim::addDS18B20(SimBrick::PIN, 0x6000, 21.5f);
+    sim::addDS18B20(SimBrick::PIN, 0x6001, 22.5f);
+    DynamicJsonDocument out(NahsBricksFeatureTemp::maxDeliverCapacity());
+    brick.powerOn();
+    brick.cycle(out);
+
+    if (corrupt) sensor->corrupt = true;
+    else {  // the sensor lost power during deep sleep and does not convert anymore
+        sensor->stuck = true;
+        sim::powerCycle();
+    }
+    NahsBricksFeatureTemp& feature = brick.wake(osMs);
+    sim::resetStats();
+    sim::advance((uint64_t)workMs * 1000);
+    out.clear();
+    feature.deliver(&out);
+    brick.sleep();
+
+    uint8_t error = 0;
+    for (JsonVariant entry : out["t"].as<JsonArray>()) {
+        if (entry[1].isNull()) error = entry[2].as<uint8_t>();
+    }
+    CHECK(error == (corrupt ? 2 : 3), "error %u delivered after %u ms of the OS", error, osMs);
+    return sim::stats;
+}
+
+static void testRetriesLateInWake() {
+    sim::Stats early = failingWake(true, 0);
+    sim::Stats late = failingWake(true, 2500);
+    CHECK(late.scratchpadReads == early.scratchpadReads, "%u scratchpad reads after 2500 ms of the OS, %u without",
+        late.scratchpadReads, early.scratchpadReads);
+
+    early = failingWake(false, 0);
+    late = failingWake(false, 2500);
+    CHECK(early.convertTs > 0, "power-on value not reconverted");
+    CHECK(late.convertTs == early.convertTs, "%u reconversions after 2500 ms of the OS, %u without", late.convertTs, early.convertTs);
+}
+
+static void testDeadlineBoundsRetries() {
+    sim::Stats late = failingWake(false, 2500, 1900);  // a reconversion would end after the deadline
+    CHECK(late.convertTs == 0, "%u reconversions started that end after the deadline", late.convertTs);
+}
+
+int main() {
+    testRetriesLateInWake();
+    testDeadlineBoundsRetries();
+    return checkResult();
+}